@@ -0,0 +1,99 @@
+#include "attackMaps.hpp"
+#include <initializer_list>
+
+static constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+static constexpr Bitboard FILE_B = FILE_A << 1;
+static constexpr Bitboard FILE_G = FILE_A << 6;
+static constexpr Bitboard FILE_H = FILE_A << 7;
+static constexpr Bitboard NOT_A = ~FILE_A;
+static constexpr Bitboard NOT_H = ~FILE_H;
+static constexpr Bitboard NOT_AB = ~(FILE_A | FILE_B);
+static constexpr Bitboard NOT_GH = ~(FILE_G | FILE_H);
+
+// Positive = towards higher bit indices (down the board / towards the h-file)
+static inline Bitboard shift(Bitboard b, int s) { return s > 0 ? b << s : b >> -s; }
+
+// Kogge-Stone occluded fill: every square reachable from 'gen' in direction
+// 's' (one step = shift by s, masked by 'mask' against file wrap), stopping
+// at the first occupied square, which is included
+static inline Bitboard slide(Bitboard gen, Bitboard empty, int s, Bitboard mask) {
+    empty &= mask;
+    gen |= empty & shift(gen, s);
+    empty &= shift(empty, s);
+    gen |= empty & shift(gen, 2 * s);
+    empty &= shift(empty, 2 * s);
+    gen |= empty & shift(gen, 4 * s);
+    return shift(gen, s) & mask;
+}
+
+static Bitboard rookAttacks(Bitboard rooks, Bitboard empty) {
+    return slide(rooks, empty, -8, ~0ULL) | slide(rooks, empty, 8, ~0ULL) |
+           slide(rooks, empty, 1, NOT_A) | slide(rooks, empty, -1, NOT_H);
+}
+
+static Bitboard bishopAttacks(Bitboard bishops, Bitboard empty) {
+    return slide(bishops, empty, -7, NOT_A) | slide(bishops, empty, -9, NOT_H) |
+           slide(bishops, empty, 9, NOT_A) | slide(bishops, empty, 7, NOT_H);
+}
+
+static Bitboard knightAttacks(Bitboard n) {
+    return ((n >> 15) & NOT_A) | ((n >> 17) & NOT_H) | ((n >> 6) & NOT_AB) | ((n >> 10) & NOT_GH) |
+           ((n << 10) & NOT_AB) | ((n << 6) & NOT_GH) | ((n << 17) & NOT_A) | ((n << 15) & NOT_H);
+}
+
+static Bitboard kingAttacksSet(Bitboard k) {
+    Bitboard sides = ((k << 1) & NOT_A) | ((k >> 1) & NOT_H);
+    Bitboard row = k | sides;
+    return sides | (row << 8) | (row >> 8);
+}
+
+Bitboard kingAttacks(int square) { return kingAttacksSet(squareBit(square)); }
+
+void computeAttackMaps(const int b[8][8], AttackMaps& maps) {
+    maps = AttackMaps();
+    for (int sq = 0; sq < 64; ++sq) {
+        int piece = b[sq / 8][sq % 8];
+        if (piece == 0) continue;
+        int colour = (piece & 0b1000) ? 1 : 0;
+        int type = piece & 0b0111;
+        maps.pieces[colour][type] |= squareBit(sq);
+        maps.pieces[colour][0] |= squareBit(sq);
+        if (type == 6) maps.kingSquare[colour] = sq;
+    }
+    maps.occupied = maps.pieces[0][0] | maps.pieces[1][0];
+    Bitboard empty = ~maps.occupied;
+
+    for (int c = 0; c < 2; ++c) {
+        Bitboard& all = maps.attacks[c][0];
+        Bitboard& twice = maps.attackedTwice[c];
+        auto add = [&](int type, Bitboard att) {
+            maps.attacks[c][type] |= att;
+            twice |= all & att;
+            all |= att;
+        };
+
+        // Pawns: both capture directions set-wise; a square hit from both sides is attacked twice
+        Bitboard pawns = maps.pieces[c][1];
+        Bitboard east = c == 0 ? (pawns >> 7) & NOT_A : (pawns << 9) & NOT_A;
+        Bitboard west = c == 0 ? (pawns >> 9) & NOT_H : (pawns << 7) & NOT_H;
+        add(1, east);
+        add(1, west);
+
+        add(6, kingAttacksSet(maps.pieces[c][6]));
+
+        for (int type : {3, 4, 2, 5}) {
+            Bitboard set = maps.pieces[c][type];
+            while (set) {
+                int sq = __builtin_ctzll(set);
+                set &= set - 1;
+                Bitboard bit = squareBit(sq);
+                Bitboard att = type == 3 ? knightAttacks(bit)
+                             : type == 4 ? bishopAttacks(bit, empty)
+                             : type == 2 ? rookAttacks(bit, empty)
+                             : rookAttacks(bit, empty) | bishopAttacks(bit, empty);
+                add(type, att);
+                if (maps.count[c] < 16) maps.list[c][maps.count[c]++] = {type, sq, att};
+            }
+        }
+    }
+}
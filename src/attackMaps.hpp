@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+
+// Bitboard attack maps for the evaluation, computed in one pass per call.
+//
+// Bit index = row * 8 + col on the engine's board (row 0 = rank 8, col 0 = a-file).
+// Colour index 0 = white, 1 = black. Piece types use the board's codes
+// (1 pawn, 2 rook, 3 knight, 4 bishop, 5 queen, 6 king); index 0 means "any".
+//
+// Pawn, knight and king attacks are generated set-wise for all pieces of a
+// type at once; sliders use Kogge-Stone occluded fills per piece so mobility
+// can be counted per piece.
+
+using Bitboard = uint64_t;
+
+struct PieceAttacks {
+    int type;
+    int square;
+    Bitboard attacks;
+};
+
+struct AttackMaps {
+    Bitboard occupied = 0;
+    Bitboard pieces[2][7] = {};         // occupancy by colour and type ([c][0] = all)
+    Bitboard attacks[2][7] = {};        // squares attacked by colour and type ([c][0] = any)
+    Bitboard attackedTwice[2] = {};     // squares attacked by at least two pieces
+    int kingSquare[2] = {-1, -1};
+
+    // Knights, bishops, rooks and queens with their individual attack sets
+    PieceAttacks list[2][16];
+    int count[2] = {0, 0};
+};
+
+// Fill 'maps' from a board in the engine's layout
+void computeAttackMaps(const int b[8][8], AttackMaps& maps);
+
+// Squares adjacent to 'square'
+Bitboard kingAttacks(int square);
+
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline Bitboard squareBit(int square) { return 1ULL << square; }
@@ -169,6 +169,10 @@ BenchResult testDeepSearch(int depth) {
     
     ChessGame game;
     Engine engine;
+#ifdef ENGINE_SEARCH_STATS
+    SearchStats stats;
+    engine.setSearchStats(&stats);
+#endif
     
     auto start = high_resolution_clock::now();
     Move bestMove = engine.getBestMove(game, depth);
@@ -183,6 +187,9 @@ BenchResult testDeepSearch(int depth) {
     
     // Print TT instrumentation summary for this engine
     engine.printTTSummary();
+#ifdef ENGINE_SEARCH_STATS
+    cout << "Search stats: " << stats.toJson() << endl;
+#endif
 
     return {"Deep Search", depth, engine.nodesSearched, engine.ttHits, hitRate, timeMs,
             (engine.nodesSearched / timeMs) * 1000.0, "Single search at depth " + to_string(depth)};
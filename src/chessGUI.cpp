@@ -15,7 +15,7 @@ ChessGUI::ChessGUI(ChessGame& chessGame)
       showPromotionDialog(false), promotionRow(-1), promotionCol(-1),
       promotionTargetRow(-1), promotionTargetCol(-1), isWhitePromotion(true),
       fontLoaded(false), texturesLoaded(false),
-      enginePlaysWhite(false), enginePlaysBlack(false), engineDepth(3), engineThinking(false) {
+      enginePlaysWhite(false), enginePlaysBlack(false), engineDepth(3), engineMoveTimeMs(5000), engineThinking(false) {
     
     initializeWindow();
     initializeColors();
@@ -726,7 +726,10 @@ bool ChessGUI::isEngineTurn() const {
 void ChessGUI::makeEngineMove() {
     engineThinking = true;
     
-    Move bestMove = engine.getBestMove(game, engineDepth);
+    SearchLimits limits;
+    limits.depth = engineDepth;
+    limits.movetimeMs = engineMoveTimeMs;
+    Move bestMove = engine.getBestMove(game, limits);
     
     if (bestMove.startRow != -1) {
         game.makeEngineMove(bestMove);
@@ -35,6 +35,7 @@ private:
     bool enginePlaysWhite;
     bool enginePlaysBlack;
     int engineDepth;
+    long long engineMoveTimeMs;  // upper bound on thinking time per move
     bool engineThinking;
     
     // Promotion dialog state
@@ -1,6 +1,6 @@
 // compare_versions.cpp - Test new versions against V1 baselines
 #include "game.hpp"
-#include "engine.hpp"
+#include "engine_impl.hpp"  // BasicEngine<EvalV1Wrapper>
 #include "engine_v1.hpp"
 #include "evaluation.hpp"
 #include "evaluation_v1.hpp"
@@ -53,14 +53,16 @@ struct GameResult {
     string termination; // raw game.getGameResult() when terminal
 };
 
-GameResult playGame(Evaluation& eval1, Evaluation& eval2, bool eval1PlaysWhite, int depth, const string& startingFEN) {
+// Templated on both evaluators so each engine searches with its own evaluation
+template <class Eval1, class Eval2>
+GameResult playGame(const Eval1& eval1, const Eval2& eval2, bool eval1PlaysWhite, int depth, const string& startingFEN) {
     ChessGame game;
     if (!startingFEN.empty()) {
         game.loadFEN(startingFEN);
     }
     
-    Engine engine1(eval1);
-    Engine engine2(eval2);
+    BasicEngine<Eval1> engine1(eval1, Engine::SELFPLAY_HASH_MB);
+    BasicEngine<Eval2> engine2(eval2, Engine::SELFPLAY_HASH_MB);
     
     int moveCount = 0;
     int maxMoves = 80;  // Reduced from 120 to get more decisive games
@@ -68,14 +70,8 @@ GameResult playGame(Evaluation& eval1, Evaluation& eval2, bool eval1PlaysWhite,
     while (!game.isGameOver() && moveCount < maxMoves) {
         bool isWhiteTurn = game.isWhiteToMove();
         
-        Engine* currentEngine = nullptr;
-        if ((isWhiteTurn && eval1PlaysWhite) || (!isWhiteTurn && !eval1PlaysWhite)) {
-            currentEngine = &engine1;
-        } else {
-            currentEngine = &engine2;
-        }
-        
-        Move bestMove = currentEngine->getBestMove(game, depth);
+        bool engine1ToMove = (isWhiteTurn && eval1PlaysWhite) || (!isWhiteTurn && !eval1PlaysWhite);
+        Move bestMove = engine1ToMove ? engine1.getBestMove(game, depth) : engine2.getBestMove(game, depth);
         
         if (bestMove.startRow == -1) {
             break;
@@ -234,7 +230,7 @@ int main() {
                 game.loadFEN(startingFEN);
             }
             
-            Engine newEngine(eval);
+            Engine newEngine(eval, Engine::SELFPLAY_HASH_MB);
             EngineV1 v1Engine(eval);
             
             int moveCount = 0;
@@ -251,19 +247,10 @@ int main() {
                 auto startTime = chrono::high_resolution_clock::now();
                 
                 if ((isWhiteTurn && newPlaysWhite) || (!isWhiteTurn && !newPlaysWhite)) {
-                    // NEW engine - iterative deepening with time limit
-                    Move currentBest(-1, -1, -1, -1);
-                    for (int d = 1; d <= 10; d++) {
-                        auto now = chrono::high_resolution_clock::now();
-                        auto elapsed = chrono::duration_cast<chrono::milliseconds>(now - startTime).count();
-                        if (elapsed >= timePerMoveMs) break;
-                        
-                        Move move = newEngine.getBestMove(game, d);
-                        if (move.startRow != -1) {
-                            currentBest = move;
-                        }
-                    }
-                    bestMove = currentBest;
+                    // NEW engine - built-in time management
+                    SearchLimits limits;
+                    limits.movetimeMs = timePerMoveMs;
+                    bestMove = newEngine.getBestMove(game, limits);
                 } else {
                     // V1 engine - iterative deepening with time limit
                     Move currentBest(-1, -1, -1, -1);
@@ -379,7 +366,7 @@ int main() {
                 game.loadFEN(startingFEN);
             }
             
-            Engine newEngine(newEval);
+            Engine newEngine(newEval, Engine::SELFPLAY_HASH_MB);
             EngineV1 v1Engine(v1Eval);
             
             int moveCount = 0;
@@ -0,0 +1,274 @@
+#include "endgame.hpp"
+#include "board.hpp"
+#include "evalParams.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Squares are row * 8 + col as on the board (row 0 = rank 8) unless noted
+static int colourPiece(int type, int colour) { return colour == 0 ? type : (type | 0b1000); }
+
+static int findPiece(const int b[8][8], int piece) {
+    for (int sq = 0; sq < 64; sq++) {
+        if (b[sq / 8][sq % 8] == piece) return sq;
+    }
+    return -1;
+}
+
+// King steps between two squares
+static int distance(int a, int b) { return std::max(std::abs(a / 8 - b / 8), std::abs(a % 8 - b % 8)); }
+
+// 1 on the four centre squares up to 7 on the edge
+static int centreDistance(int sq) { return std::max(std::abs(2 * (sq / 8) - 7), std::abs(2 * (sq % 8) - 7)); }
+
+static bool isLightSquare(int sq) { return (sq / 8 + sq % 8) % 2 == 0; }
+
+static int kingSteps(int sq, int out[8]) {
+    int n = 0;
+    for (int dr = -1; dr <= 1; dr++) {
+        for (int dc = -1; dc <= 1; dc++) {
+            int r = sq / 8 + dr, c = sq % 8 + dc;
+            if ((dr || dc) && r >= 0 && r < 8 && c >= 0 && c < 8) out[n++] = r * 8 + c;
+        }
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// KPK bitbase. Positions are normalised so the pawn side is white with the
+// pawn on files a-d; squares here are rank * 8 + file, rank 0 = white's first.
+// Retrograde iteration from the positions decided in one move (promotion,
+// pawn captured, stalemate); anything left undecided is a draw.
+
+static constexpr int KPK_SIZE = 2 * 64 * 64 * 24;
+enum KpkResult : uint8_t { KPK_INVALID = 0, KPK_UNKNOWN = 1, KPK_DRAW = 2, KPK_WIN = 4 };
+
+// stm 0 = the pawn side to move
+static int kpkIndex(int stm, int weakKing, int strongKing, int pawn) {
+    return stm + 2 * (weakKing + 64 * (strongKing + 64 * ((pawn / 8 - 1) * 4 + pawn % 8)));
+}
+
+static bool pawnAttacks(int pawn, int sq) {
+    return sq / 8 == pawn / 8 + 1 && std::abs(sq % 8 - pawn % 8) == 1;
+}
+
+static KpkResult kpkInitial(int stm, int weakKing, int strongKing, int pawn) {
+    if (distance(weakKing, strongKing) <= 1 || strongKing == pawn || weakKing == pawn) return KPK_INVALID;
+    if (stm == 0 && pawnAttacks(pawn, weakKing)) return KPK_INVALID;
+
+    // Promotes and the new queen can't be taken
+    int push = pawn + 8;
+    if (stm == 0 && pawn / 8 == 6 && strongKing != push &&
+        (distance(weakKing, push) > 1 || distance(strongKing, push) == 1)) {
+        return KPK_WIN;
+    }
+
+    if (stm == 1) {
+        int steps[8];
+        int n = kingSteps(weakKing, steps);
+        bool canMove = false;
+        for (int i = 0; i < n; i++) {
+            if (distance(steps[i], strongKing) <= 1 || pawnAttacks(pawn, steps[i])) continue;
+            if (steps[i] == pawn) return KPK_DRAW;  // undefended pawn captured
+            canMove = true;
+        }
+        if (!canMove) return KPK_DRAW;  // stalemate
+    }
+    return KPK_UNKNOWN;
+}
+
+static KpkResult kpkClassify(const std::vector<uint8_t>& db, int stm, int weakKing, int strongKing, int pawn) {
+    // The side to move picks its best reply: the pawn side wins if any move
+    // wins, the defender draws if any move draws
+    const uint8_t good = stm == 0 ? KPK_WIN : KPK_DRAW;
+    const uint8_t bad = stm == 0 ? KPK_DRAW : KPK_WIN;
+    uint8_t replies = KPK_INVALID;
+    int steps[8];
+    int n = kingSteps(stm == 0 ? strongKing : weakKing, steps);
+    for (int i = 0; i < n; i++) {
+        replies |= stm == 0 ? db[kpkIndex(1, weakKing, steps[i], pawn)] : db[kpkIndex(0, steps[i], strongKing, pawn)];
+    }
+    if (stm == 0 && pawn / 8 < 6) {
+        replies |= db[kpkIndex(1, weakKing, strongKing, pawn + 8)];
+        if (pawn / 8 == 1 && pawn + 8 != weakKing && pawn + 8 != strongKing) {
+            replies |= db[kpkIndex(1, weakKing, strongKing, pawn + 16)];
+        }
+    }
+    if (replies & good) return static_cast<KpkResult>(good);
+    return (replies & KPK_UNKNOWN) ? KPK_UNKNOWN : static_cast<KpkResult>(bad);
+}
+
+class KpkBitbase {
+public:
+    KpkBitbase() : wins(KPK_SIZE / 64, 0) {
+        std::vector<uint8_t> db(KPK_SIZE);
+        for (int idx = 0; idx < KPK_SIZE; idx++) {
+            int p = idx >> 13;
+            db[idx] = kpkInitial(idx & 1, (idx >> 1) & 63, (idx >> 7) & 63, (p / 4 + 1) * 8 + p % 4);
+        }
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int idx = 0; idx < KPK_SIZE; idx++) {
+                if (db[idx] != KPK_UNKNOWN) continue;
+                int p = idx >> 13;
+                db[idx] = kpkClassify(db, idx & 1, (idx >> 1) & 63, (idx >> 7) & 63, (p / 4 + 1) * 8 + p % 4);
+                changed |= db[idx] != KPK_UNKNOWN;
+            }
+        }
+        for (int idx = 0; idx < KPK_SIZE; idx++) {
+            if (db[idx] == KPK_WIN) wins[idx / 64] |= uint64_t(1) << (idx % 64);
+        }
+    }
+
+    bool win(int idx) const { return (wins[idx / 64] >> (idx % 64)) & 1; }
+
+private:
+    std::vector<uint64_t> wins;
+};
+
+bool kpkIsWin(const int b[8][8], bool whiteToMove) {
+    static const KpkBitbase bitbase;
+    int strong = 0;
+    int pawn = findPiece(b, WHITE_PAWN);
+    if (pawn < 0) {
+        strong = 1;
+        pawn = findPiece(b, BLACK_PAWN);
+    }
+    int strongKing = findPiece(b, colourPiece(6, strong));
+    int weakKing = findPiece(b, colourPiece(6, 1 - strong));
+    bool mirror = pawn % 8 >= 4;
+    auto normalise = [&](int sq) {
+        int rank = strong == 0 ? 7 - sq / 8 : sq / 8;
+        int file = mirror ? 7 - sq % 8 : sq % 8;
+        return rank * 8 + file;
+    };
+    int stm = whiteToMove == (strong == 0) ? 0 : 1;
+    return bitbase.win(kpkIndex(stm, normalise(weakKing), normalise(strongKing), normalise(pawn)));
+}
+
+// ---------------------------------------------------------------------------
+// Evaluation functions (pawns, strong side positive)
+
+static double strongMaterial(const int b[8][8], int strong) {
+    const int* material = evalParams().material;
+    double total = 0.0;
+    for (int sq = 0; sq < 64; sq++) {
+        int piece = b[sq / 8][sq % 8];
+        if (piece != EMPTY && ((piece & 0b1000) ? 1 : 0) == strong) total += material[piece & 0b0111] / 100.0;
+    }
+    return total;
+}
+
+static double evaluateDraw(const int[8][8], int, bool) { return 0.0; }
+
+// Lone king against mating material: drive it to the edge, bring the king up
+static double evaluateKXK(const int b[8][8], int strong, bool) {
+    int strongKing = findPiece(b, colourPiece(6, strong));
+    int weakKing = findPiece(b, colourPiece(6, 1 - strong));
+    return KNOWN_WIN + strongMaterial(b, strong) + 0.1 * centreDistance(weakKing) +
+           0.1 * (7 - distance(strongKing, weakKing));
+}
+
+// Mate is only possible in a corner of the bishop's colour
+static double evaluateKBNK(const int b[8][8], int strong, bool) {
+    int strongKing = findPiece(b, colourPiece(6, strong));
+    int weakKing = findPiece(b, colourPiece(6, 1 - strong));
+    int bishop = findPiece(b, colourPiece(4, strong));
+    int corner = isLightSquare(bishop) ? std::min(distance(weakKing, 0), distance(weakKing, 63))
+                                       : std::min(distance(weakKing, 7), distance(weakKing, 56));
+    return KNOWN_WIN + strongMaterial(b, strong) + 0.2 * (7 - corner) + 0.1 * (7 - distance(strongKing, weakKing));
+}
+
+static double evaluateKPK(const int b[8][8], int strong, bool whiteToMove) {
+    if (!kpkIsWin(b, whiteToMove)) return 0.0;
+    int pawn = findPiece(b, colourPiece(1, strong));
+    int advance = strong == 0 ? 6 - pawn / 8 : pawn / 8 - 1;  // 0 on the starting rank
+    return KNOWN_WIN + evalParams().material[1] / 100.0 + 0.1 * advance;
+}
+
+// ---------------------------------------------------------------------------
+// Scaling functions
+
+// KRKB, KRKN: the rook rarely wins
+static double scaleRookVsMinor(const int[8][8], int) { return 0.125; }
+
+// A rook pawn whose promotion square the bishop doesn't cover is a draw once
+// the defending king reaches the corner
+static double scaleKBPK(const int b[8][8], int strong) {
+    int pawn = findPiece(b, colourPiece(1, strong));
+    if (pawn % 8 != 0 && pawn % 8 != 7) return 1.0;
+    int promotion = (strong == 0 ? 0 : 56) + pawn % 8;
+    int bishop = findPiece(b, colourPiece(4, strong));
+    int weakKing = findPiece(b, colourPiece(6, 1 - strong));
+    bool wrongBishop = isLightSquare(bishop) != isLightSquare(promotion);
+    return wrongBishop && distance(weakKing, promotion) <= 1 ? 0.0 : 1.0;
+}
+
+// Bishops and pawns only: opposite-coloured bishops are drawish
+static double scaleOppositeBishops(const int b[8][8], int) {
+    return isLightSquare(findPiece(b, WHITE_BISHOP)) != isLightSquare(findPiece(b, BLACK_BISHOP)) ? 0.5 : 1.0;
+}
+
+// ---------------------------------------------------------------------------
+// Material table
+
+// Key for a signature like "KBNK": pieces before the second K belong to 'strong'
+static MaterialKey keyFromCode(const std::string& code, int strong) {
+    MaterialKey key = 0;
+    size_t weakStart = code.find('K', 1);
+    for (size_t i = 0; i < code.size(); i++) {
+        int type = static_cast<int>(std::string("PRNBQK").find(code[i])) + 1;
+        key += materialKeyOf(colourPiece(type, i < weakStart ? strong : 1 - strong));
+    }
+    return key;
+}
+
+using EndgameTable = std::unordered_map<MaterialKey, EndgameEntry>;
+
+static EndgameTable buildEndgames() {
+    EndgameTable table;
+    auto add = [&](const char* code, decltype(EndgameEntry::evaluate) evaluate, decltype(EndgameEntry::scale) scale) {
+        for (int strong = 0; strong < 2; strong++) table[keyFromCode(code, strong)] = {evaluate, scale, strong};
+    };
+    add("KK", evaluateDraw, nullptr);
+    add("KNK", evaluateDraw, nullptr);
+    add("KBK", evaluateDraw, nullptr);
+    add("KNNK", evaluateDraw, nullptr);
+    add("KPK", evaluateKPK, nullptr);
+    add("KBNK", evaluateKBNK, nullptr);
+    add("KRKB", nullptr, scaleRookVsMinor);
+    add("KRKN", nullptr, scaleRookVsMinor);
+    add("KBPK", nullptr, scaleKBPK);
+    return table;
+}
+
+const EndgameEntry* findEndgame(MaterialKey key) {
+    static const EndgameTable table = buildEndgames();
+    static const EndgameEntry KXK[2] = {{evaluateKXK, nullptr, 0}, {evaluateKXK, nullptr, 1}};
+    static const EndgameEntry OPPOSITE_BISHOPS = {nullptr, scaleOppositeBishops, 0};
+    const MaterialKey WHITE_SIDE = (MaterialKey(1) << 24) - 1;
+    const MaterialKey KINGS = (0xFULL << materialShift(WHITE_KING)) | (0xFULL << materialShift(BLACK_KING));
+    const MaterialKey PAWNS = (0xFULL << materialShift(WHITE_PAWN)) | (0xFULL << materialShift(BLACK_PAWN));
+
+    auto it = table.find(key);
+    if (it != table.end()) return &it->second;
+
+    // Lone king against a queen, a rook or two minors other than two knights
+    for (int strong = 0; strong < 2; strong++) {
+        MaterialKey weakSide = strong == 0 ? key >> 24 : key & WHITE_SIDE;
+        if (weakSide != materialKeyOf(WHITE_KING)) continue;
+        int queens = materialCount(key, colourPiece(5, strong));
+        int rooks = materialCount(key, colourPiece(2, strong));
+        int bishops = materialCount(key, colourPiece(4, strong));
+        int knights = materialCount(key, colourPiece(3, strong));
+        if (queens || rooks || bishops >= 2 || (bishops && knights)) return &KXK[strong];
+    }
+
+    if ((key & ~(KINGS | PAWNS)) == materialKeyOf(WHITE_BISHOP) + materialKeyOf(BLACK_BISHOP)) {
+        return &OPPOSITE_BISHOPS;
+    }
+    return nullptr;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "materialKey.hpp"
+
+// Specialised knowledge for endings the general evaluation gets wrong or
+// only resolves by deep search. Entries are found by material key:
+//  - an evaluation function replaces the whole evaluation with an exact or
+//    near-exact score (trivial draws, KPK from a bitbase, KBNK, lone king
+//    against mating material);
+//  - a scaling function multiplies the general evaluation towards a draw
+//    (KRKB, KRKN, wrong rook pawn KBPK, opposite-coloured bishops).
+
+// Scores far above any positional edge but well below mate, so a known win
+// is preferred to anything else yet never mistaken for a forced mate
+constexpr double KNOWN_WIN = 10.0;
+
+struct EndgameEntry {
+    // Score in pawns from the strong side's point of view
+    double (*evaluate)(const int b[8][8], int strong, bool whiteToMove);
+    // Factor in [0, 1] for the general evaluation
+    double (*scale)(const int b[8][8], int strong);
+    int strong;  // 0 = white, 1 = black
+
+    // evaluate() as a white-positive score
+    double value(const int b[8][8], bool whiteToMove) const {
+        double score = evaluate(b, strong, whiteToMove);
+        return strong == 0 ? score : -score;
+    }
+};
+
+// The entry for this material, or nullptr if none applies
+const EndgameEntry* findEndgame(MaterialKey key);
+
+// KPK bitbase: true if the side with the pawn wins. 'b' holds exactly two
+// kings and one pawn. The table is generated on first use.
+bool kpkIsWin(const int b[8][8], bool whiteToMove);
@@ -3,15 +3,30 @@
 #include "game.hpp"
 #include "evaluation.hpp"
 #include "moveGeneration.hpp"
+#include "searchStats.hpp"
+#include "tablebase.hpp"
 #include <iostream>
 #include <vector>
 #include <atomic>
 #include <string>
 #include <limits>
+#include <type_traits>
 #include <cstdint>
 #include <random>
 #include <array>
 #include <cstring>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
+#ifdef _WIN32
+#include <malloc.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 // Transposition table entry
 enum class TTBound : int {
@@ -26,6 +41,7 @@ struct TTEntry {
     TTBound bound = TTBound::EXACT; // Whether the stored score is exact, a lower bound or an upper bound
     int mateDistance = 0; // If this entry represents a mate score, store mate-in-N (plies) here. 0 = not a mate
     uint32_t packedMove = 0; // optional packed move for move ordering
+    double staticEval = std::numeric_limits<double>::quiet_NaN(); // NaN = not stored
 };
 
 // Utility: pack/unpack Move into a 32-bit integer for compact TT storage.
@@ -51,36 +67,42 @@ static inline Move unpackMove(uint32_t p) {
     return Move(sR, sC, tR, tC, mt, promo);
 }
 
-// Simple fixed-size transposition table (2-way associative)
+// Simple fixed-size transposition table (4-way associative)
 // Implemented inline here to avoid adding new compilation units.
 class TranspositionTable {
 public:
-    TranspositionTable() : buckets_(0), ways_(2), curAge_(1) {}
+    TranspositionTable() : buckets_(0), ways_(4), curAge_(1) {}
 
     ~TranspositionTable() = default;
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
 
-    // Initialize table with approx size in megabytes (default 64 MB)
-    void init(size_t sizeMB = 256) {
-        // estimate entries assuming ~32 bytes per entry
-        size_t approxEntries = (sizeMB * 1024ULL * 1024ULL) / sizeof(EntryPacked);
-        // increase associativity to reduce destructive collisions
+    // Allocate a table of approximately sizeMB megabytes (rounded down to a power
+    // of two buckets). With largePages on Linux the memory is 2 MB aligned and
+    // advised for transparent huge pages, which cuts TLB misses on large tables.
+    void init(size_t sizeMB, bool largePages = false) {
+        size_t approxEntries = (std::max<size_t>(sizeMB, 1) * 1024ULL * 1024ULL) / sizeof(EntryPacked);
         ways_ = 4;
-        size_t targetBuckets = approxEntries / ways_;
-        if (targetBuckets == 0) targetBuckets = 1;
-        // round up to next power of two
+        size_t targetBuckets = std::max<size_t>(approxEntries / ways_, 1);
+        // round down to a power of two so we never exceed the requested size
         size_t b = 1;
-        while (b < targetBuckets) b <<= 1;
-        buckets_ = b;
-        try {
-            table_.assign(buckets_ * ways_, EntryPacked());
-        } catch(...) {
-            // ignore allocation failures
-            table_.clear();
-            buckets_ = 0;
+        while (b * 2 <= targetBuckets) b <<= 1;
+
+        table_.reset();
+        buckets_ = 0;
+        tableSize_ = 0;
+        // On allocation failure retry with half the size rather than running without a table
+        for (; b > 0 && !table_; b >>= 1) {
+            table_ = allocateEntries(b * ways_, largePages);
+            if (table_) buckets_ = b;
         }
-        curAge_ = 1;
+        tableSize_ = buckets_ * ways_;
+        clear();
     }
 
+    // Size of the allocated table in megabytes
+    size_t sizeMB() const { return tableSize_ * sizeof(EntryPacked) / (1024ULL * 1024ULL); }
+
     // Instrumentation counters
     mutable std::atomic<uint64_t> probeCount{0};
     mutable std::atomic<uint64_t> probeHitCount{0};
@@ -91,7 +113,7 @@ public:
 
     // Probe for key; if found, fill outEntry and return true
     bool probe(uint64_t key, TTEntry &outEntry) const {
-        if (buckets_ == 0 || table_.empty()) return false;
+        if (buckets_ == 0) return false;
         probeCount.fetch_add(1, std::memory_order_relaxed);
         size_t idx = static_cast<size_t>(key) & (buckets_ - 1);
         size_t base = idx * ways_;
@@ -104,28 +126,41 @@ public:
                 outEntry.bound = static_cast<TTBound>(e.bound);
                 outEntry.mateDistance = e.mateDistance;
                 outEntry.packedMove = e.packedMove;
+                outEntry.staticEval = e.staticEval;
                 return true;
             }
         }
         return false;
     }
 
-    // Store an entry (replacement policy: prefer deeper entries, then older)
-    void store(uint64_t key, double score, int depth, TTBound bound, int mateDistance, uint32_t packedMove = 0) {
-    if (buckets_ == 0) init(256); // lazy init
+    // Start a new search generation. Entries written by earlier searches stay
+    // probe-able but become preferred replacement victims as they age.
+    void newSearch() { curAge_++; }
+
+    // Store an entry. Replacement policy: same key is refreshed; otherwise take an
+    // empty slot, else evict the slot with the lowest (depth - 8 * generations old),
+    // so deep entries from the current search survive and stale ones go first.
+    // staticEval is the node's static evaluation if one was computed (NaN if not).
+    void store(uint64_t key, double score, int depth, TTBound bound, int mateDistance, uint32_t packedMove = 0,
+               double staticEval = std::numeric_limits<double>::quiet_NaN()) {
         if (buckets_ == 0) return;
-    storeCount.fetch_add(1, std::memory_order_relaxed);
+        storeCount.fetch_add(1, std::memory_order_relaxed);
         size_t idx = static_cast<size_t>(key) & (buckets_ - 1);
         size_t base = idx * ways_;
 
-        // If matching key exists, update if the new depth is deeper or overwrite
+        // If matching key exists, overwrite when the new result is at least as deep
+        // or the old one is from a previous search; always refresh its age
         for (size_t w = 0; w < ways_; ++w) {
             EntryPacked &e = table_[base + w];
             if (e.key == key) {
-                if (depth >= e.depth) {
-                    e.score = score; e.depth = depth; e.bound = static_cast<uint8_t>(bound); e.mateDistance = mateDistance; e.age = curAge_; e.packedMove = packedMove;
+                if (depth >= e.depth || e.age != curAge_) {
+                    // keep the old move if this search produced none
+                    uint32_t move = packedMove ? packedMove : e.packedMove;
+                    e.score = score; e.depth = depth; e.bound = static_cast<uint8_t>(bound); e.mateDistance = mateDistance; e.packedMove = move;
                 }
-                curAge_++;
+                // static eval depends only on the position, so any computed value is kept
+                if (!std::isnan(staticEval)) e.staticEval = static_cast<float>(staticEval);
+                e.age = curAge_;
                 return;
             }
         }
@@ -134,64 +169,34 @@ public:
         for (size_t w = 0; w < ways_; ++w) {
             EntryPacked &e = table_[base + w];
             if (e.key == 0) {
-                e.key = key; e.score = score; e.depth = depth; e.bound = static_cast<uint8_t>(bound); e.mateDistance = mateDistance; e.age = curAge_++; e.packedMove = packedMove;
+                e.key = key; e.score = score; e.depth = depth; e.bound = static_cast<uint8_t>(bound); e.mateDistance = mateDistance; e.age = curAge_; e.packedMove = packedMove;
+                e.staticEval = static_cast<float>(staticEval);
                 return;
             }
         }
 
-        // Replacement policy: avoid overwriting exact+deep entries when possible
-        // Find the slot with the worst priority to replace: prefer shallower depth, older age, and non-EXACT bound
-    size_t replaceIdx = 0;
-        int32_t worstDepth = table_[base].depth;
-        uint8_t worstAge = table_[base].age;
-        uint8_t worstBound = table_[base].bound;
+        // Pick the victim with the lowest replacement priority; at equal priority
+        // non-EXACT entries go before EXACT ones
+        size_t replaceIdx = 0;
+        int worstPriority = replacePriority(table_[base]);
         for (size_t w = 1; w < ways_; ++w) {
-            EntryPacked &e = table_[base + w];
-            bool isWorse = false;
-            if (e.depth < worstDepth) isWorse = true;
-            else if (e.depth == worstDepth) {
-                // prefer to replace non-EXACT entries
-                if (e.bound != 0 && worstBound == 0) isWorse = true;
-                else if (e.age <= worstAge) isWorse = true;
-            }
-            if (isWorse) {
+            const EntryPacked &e = table_[base + w];
+            int p = replacePriority(e);
+            if (p < worstPriority ||
+                (p == worstPriority && e.bound != static_cast<uint8_t>(TTBound::EXACT) &&
+                 table_[base + replaceIdx].bound == static_cast<uint8_t>(TTBound::EXACT))) {
                 replaceIdx = w;
-                worstDepth = e.depth;
-                worstAge = e.age;
-                worstBound = e.bound;
+                worstPriority = p;
             }
         }
 
-        // If the chosen victim is an EXACT entry and deeper than new depth, try to find any non-EXACT
-        EntryPacked &victim = table_[base + replaceIdx];
-        // record that we're about to replace someone
         replaceCount.fetch_add(1, std::memory_order_relaxed);
-        if (victim.bound == static_cast<uint8_t>(TTBound::EXACT) && victim.depth > depth) {
-            bool foundAlt = false;
-            for (size_t w = 0; w < ways_; ++w) {
-                EntryPacked &e = table_[base + w];
-                if (e.bound != static_cast<uint8_t>(TTBound::EXACT)) {
-                    replaceIdx = w; foundAlt = true; break;
-                }
-            }
-            if (!foundAlt) {
-                // keep the deeper exact entry; fall back to replacing the oldest
-                size_t oldest = 0;
-                uint8_t oldestAge = table_[base].age;
-                for (size_t w = 1; w < ways_; ++w) {
-                    if (table_[base + w].age > oldestAge) { oldest = w; oldestAge = table_[base + w].age; }
-                }
-                replaceIdx = oldest;
-            }
-        }
-
-        // Perform replace at replaceIdx
         EntryPacked &target = table_[base + replaceIdx];
-        // if victim was exact and deeper than new depth, count it
         if (target.bound == static_cast<uint8_t>(TTBound::EXACT) && target.depth > depth) {
             overwrittenExactCount.fetch_add(1, std::memory_order_relaxed);
         }
-        target.key = key; target.score = score; target.depth = depth; target.bound = static_cast<uint8_t>(bound); target.mateDistance = mateDistance; target.age = curAge_++; target.packedMove = packedMove;
+        target.key = key; target.score = score; target.depth = depth; target.bound = static_cast<uint8_t>(bound); target.mateDistance = mateDistance; target.age = curAge_; target.packedMove = packedMove;
+        target.staticEval = static_cast<float>(staticEval);
         // histogram of stored depths
         size_t dh = (depth >= 15) ? 15 : (size_t)depth;
         storeDepthHist[dh]++;
@@ -205,6 +210,7 @@ public:
         uint64_t replaces = replaceCount.load(std::memory_order_relaxed);
         uint64_t overwrittenExact = overwrittenExactCount.load(std::memory_order_relaxed);
         cout << "\nTranspositionTable summary:\n";
+        cout << "  size: " << sizeMB() << " MB (" << capacity() << " slots), hashfull: " << hashfull() << " permille\n";
         cout << "  probes: " << probes << ", hits: " << hits << ", hit%: ";
         if (probes) cout << (100.0 * hits / probes) << "%\n"; else cout << "0%\n";
         cout << "  stores: " << stores << ", replacements: " << replaces << ", overwrittenExact: " << overwrittenExact << "\n";
@@ -215,11 +221,28 @@ public:
         }
     }
 
-    // Clear table
+    // Zero the table. Large tables are cleared by several threads since a
+    // single-threaded memset of a few GB dominates ucinewgame/startup time.
     void clear() {
-        if (table_.empty()) return;
-        for (auto &e : table_) {
-            e.key = 0; e.score = 0.0; e.depth = 0; e.mateDistance = 0; e.bound = 0; e.age = 0; e.packedMove = 0;
+        if (tableSize_ > 0) {
+            const size_t bytes = tableSize_ * sizeof(EntryPacked);
+            const size_t PARALLEL_CLEAR_BYTES = 32ULL * 1024ULL * 1024ULL;
+            size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+            if (bytes < PARALLEL_CLEAR_BYTES || nThreads == 1) {
+                std::memset(static_cast<void*>(table_.get()), 0, bytes);
+            } else {
+                nThreads = std::min<size_t>(nThreads, 8);
+                std::vector<std::thread> workers;
+                size_t chunk = tableSize_ / nThreads;
+                for (size_t t = 0; t < nThreads; ++t) {
+                    size_t begin = t * chunk;
+                    size_t count = (t + 1 == nThreads) ? tableSize_ - begin : chunk;
+                    workers.emplace_back([this, begin, count]() {
+                        std::memset(static_cast<void*>(table_.get() + begin), 0, count * sizeof(EntryPacked));
+                    });
+                }
+                for (auto &w : workers) w.join();
+            }
         }
         curAge_ = 1;
     }
@@ -227,58 +250,298 @@ public:
     // Approximate number of slots
     size_t capacity() const { return buckets_ * ways_; }
 
+    // Occupancy in permille, sampled from the first 1000 slots (UCI "hashfull").
+    // Only entries written by the current search count as full.
+    int hashfull() const {
+        size_t n = std::min<size_t>(1000, tableSize_);
+        if (n == 0) return 0;
+        size_t used = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (table_[i].key != 0 && table_[i].age == curAge_) used++;
+        }
+        return static_cast<int>(used * 1000 / n);
+    }
+
 private:
+    // 32 bytes: depth and mate distance fit in 16 bits, which leaves room for
+    // the static eval (float precision is plenty for a pawn-unit score)
     struct EntryPacked {
         uint64_t key = 0;
         double score = 0.0;
-        int32_t depth = 0;
-        int32_t mateDistance = 0;
+        int16_t depth = 0;
+        int16_t mateDistance = 0;
         uint8_t bound = 0;
         uint8_t age = 0;
         uint32_t packedMove = 0;
+        float staticEval = std::numeric_limits<float>::quiet_NaN();
+    };
+
+    // Aligned storage released with the matching deallocator
+    struct AlignedDeleter {
+        void operator()(EntryPacked* p) const {
+#ifdef _WIN32
+            _aligned_free(p);
+#else
+            std::free(p);
+#endif
+        }
     };
 
-    std::vector<EntryPacked> table_; // contiguous storage: buckets * ways
+    static std::unique_ptr<EntryPacked[], AlignedDeleter> allocateEntries(size_t count, bool largePages) {
+        const size_t bytes = count * sizeof(EntryPacked);
+#if defined(_WIN32)
+        (void)largePages;
+        void* mem = _aligned_malloc(bytes, 64);
+#elif defined(__linux__)
+        const size_t HUGE_PAGE = 2ULL * 1024ULL * 1024ULL;
+        size_t alignment = largePages && bytes >= HUGE_PAGE ? HUGE_PAGE : 64;
+        size_t rounded = (bytes + alignment - 1) / alignment * alignment;
+        void* mem = std::aligned_alloc(alignment, rounded);
+        if (mem && alignment == HUGE_PAGE) madvise(mem, rounded, MADV_HUGEPAGE);
+#else
+        (void)largePages;
+        void* mem = nullptr;
+        if (posix_memalign(&mem, 64, bytes) != 0) mem = nullptr;
+#endif
+        return std::unique_ptr<EntryPacked[], AlignedDeleter>(static_cast<EntryPacked*>(mem));
+    }
+
+    // Generations since the entry was written (uint8 wrap-around is fine)
+    int relativeAge(const EntryPacked &e) const { return static_cast<uint8_t>(curAge_ - e.age); }
+    int replacePriority(const EntryPacked &e) const { return e.depth - 8 * relativeAge(e); }
+
+    std::unique_ptr<EntryPacked[], AlignedDeleter> table_; // contiguous storage: buckets * ways
+    size_t tableSize_ = 0;
     size_t buckets_ = 0; // power-of-two
-    size_t ways_ = 2;
+    size_t ways_ = 4;
     uint8_t curAge_ = 1;
 };
 
-class Engine {
+// Small direct-mapped cache of static evaluations keyed by Zobrist hash.
+// Catches re-evaluations the TT can't: quiescence nodes (never stored in the
+// TT) and positions whose TT entry was overwritten. Evaluation depends only on
+// the position, so entries stay valid across searches; newGame() clears them
+// in case the evaluation parameters were reloaded.
+class EvalHash {
+public:
+    explicit EvalHash(size_t entries = 1 << 16) {
+        size_t n = 1;
+        while (n * 2 <= entries) n <<= 1;
+        table_.assign(n, Entry());
+    }
+
+    bool probe(uint64_t key, double &outEval) {
+        probeCount++;
+        const Entry &e = table_[key & (table_.size() - 1)];
+        if (e.key != key) return false;
+        hitCount++;
+        outEval = e.eval;
+        return true;
+    }
+
+    void clear() { std::fill(table_.begin(), table_.end(), Entry()); }
+
+    void store(uint64_t key, double eval) {
+        Entry &e = table_[key & (table_.size() - 1)];
+        e.key = key;
+        e.eval = eval;
+    }
+
+    uint64_t probeCount = 0;
+    uint64_t hitCount = 0;
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        double eval = 0.0;
+    };
+    std::vector<Entry> table_;
+};
+
+// Search limits for a single getBestMove call. A value of 0 means "no limit"
+// for that field; with nothing set the search runs to MAX_SEARCH_DEPTH.
+struct SearchLimits {
+    int depth = 0;                 // maximum iteration depth
+    long long movetimeMs = 0;      // fixed time for this move
+    long long wtimeMs = 0;         // remaining clock time (white / black)
+    long long btimeMs = 0;
+    long long wincMs = 0;          // increment per move (white / black)
+    long long bincMs = 0;
+    int movestogo = 0;             // moves until next time control (0 = sudden death)
+    uint64_t nodes = 0;            // node budget
+    bool infinite = false;         // search until stop() is called
+};
+
+// Outcome of the last completed iteration of a search
+struct SearchResult {
+    Move bestMove = Move(-1, -1, -1, -1);
+    double score = 0.0;            // white-relative score of bestMove
+    int depth = 0;                 // depth of the last completed iteration
+    uint64_t nodes = 0;
+    uint64_t tbHits = 0;           // positions answered by the endgame tablebases
+    long long timeMs = 0;
+    std::vector<Move> pv;          // principal variation starting with bestMove
+};
+
+// True if Eval offers the lazy evaluate(game, alpha, beta). A policy that
+// hides Evaluation::evaluate hides the windowed overload too, so it is only
+// used with the evaluation it was written for.
+template <class Eval, class = void>
+struct HasWindowedEvaluate : std::false_type {};
+template <class Eval>
+struct HasWindowedEvaluate<Eval, std::void_t<decltype(std::declval<const Eval&>().evaluate(
+    std::declval<const ChessGame&>(), 0.0, 0.0))>> : std::true_type {};
+
+// Alpha-beta search, templated on the evaluator so tools with their own
+// evaluation (tuning, genetic PST, version comparison) get it called directly
+// and inlined instead of sliced to the base Evaluation. An evaluator policy
+// provides evaluate(const ChessGame&) and materialCount(const ChessGame&);
+// deriving from Evaluation and hiding evaluate() is enough. An optional
+// evaluate(game, alpha, beta) is used for quiescence stand-pat.
+template <class Eval = Evaluation>
+class BasicEngine {
 private:
-    Evaluation evaluator;
+    Eval evaluator;
     TranspositionTable transpositionTable;
+    EvalHash evalHash;
+    uint64_t ttStaticEvalHits = 0;  // static evals taken from TT entries
+    // evaluator.evaluate() behind the eval hash
+    double evaluateCached(ChessGame& game);
+    // Windowed (lazy) variant; only exact scores are cached
+    double evaluateCached(ChessGame& game, double alpha, double beta);
+    uint64_t evalsOutsideWindow = 0;  // windowed evals not cached (possibly lazy bounds)
     Move pvMove = Move(-1, -1, -1, -1);  // Initialize to invalid move
+
+    // Time / node management. The stop flag may be raised from another thread;
+    // searchAborted is the search-thread-local latch once any limit is hit.
+    static constexpr int MAX_SEARCH_DEPTH = 64;
+    std::atomic<bool> stopFlag{false};
+    bool searchAborted = false;
+    std::chrono::steady_clock::time_point searchStart;
+    long long softLimitMs = 0;   // don't start a new iteration after this
+    long long hardLimitMs = 0;   // abort the running iteration after this
+    uint64_t nodeLimit = 0;
+    uint64_t proverNodes = 0;    // mate prover nodes (kept out of nodesSearched)
+    void setupLimits(const SearchLimits& limits, bool whiteToMove);
+    bool checkLimits();          // polled from alphabeta/quiescence
+    long long elapsedMs() const;
     // Killer moves: two killers per ply (store packed moves)
     static constexpr int MAX_PLY = 128;
     std::array<std::array<uint32_t,2>, MAX_PLY> killers;
-    // History heuristic: indexed by from*64 + to
+    // History heuristic: indexed by from*64 + to. All history tables are kept
+    // within [-HISTORY_MAX, HISTORY_MAX] by gravity (see applyHistoryBonus).
+    static constexpr int HISTORY_MAX = 16384;
     std::array<int, 64*64> history;
+    // Piece-to index (piece code 0..15, square 0..63) used by the tables below
+    static int pieceTo(int piece, int square) { return piece * 64 + square; }
+    static constexpr int PIECE_TO_SIZE = 16 * 64;
+    // Counter moves: the reply that refuted the opponent's previous move, by its piece-to
+    std::array<uint32_t, PIECE_TO_SIZE> counterMoves;
+    // Continuation history: [previous piece-to][current piece-to]. Shared by the
+    // 1-ply (opponent's move) and 2-ply (own move) contexts; their pieces have
+    // opposite colours so the entries never collide.
+    std::vector<int16_t> continuationHistory;
+    // Capture history: [attacker piece-to][captured piece type]
+    std::array<int, PIECE_TO_SIZE * 8> captureHistory;
+    // Piece-to of the move made at each ply (-1 for a null move)
+    std::array<int, MAX_PLY> plyPieceTo;
+    void clearHeuristics();
+    // Combined butterfly + continuation history of a quiet move at 'ply'
+    int quietHistory(const Move& move, int ply) const;
+    int captureHistoryScore(const Move& move) const;
+    // On a cutoff: reward 'best', penalise the quiets/captures searched before it
+    void updateCutoffStats(const Move& best, bool bestIsCapture, int depth, int ply,
+                           const vector<Move>& quietsTried, const vector<Move>& capturesTried);
+    // Triangular PV table (packed moves): row 'ply' holds the best line found
+    // from that ply, valid for indices [ply, pvLength[ply])
+    std::array<std::array<uint32_t, MAX_PLY>, MAX_PLY> pvTable;
+    std::array<int, MAX_PLY> pvLength;
+    // PV of the previous iteration; searched first while the current path still follows it
+    std::vector<uint32_t> prevPV;
+    bool followPV = false;
+    void updatePV(int ply, const Move& move);
+
+    // Late move reductions: plies to reduce a quiet move searched as the
+    // moveIndex-th move at 'depth'. Killers and high-history moves are
+    // reduced less, moves at non-PV (zero-window) nodes more.
+    static constexpr int LMR_FULL_DEPTH_MOVES = 3;
+    static constexpr double ZERO_WINDOW = 0.001;  // pawns
+    int lateMoveReduction(int depth, int moveIndex, const Move& move, int ply, bool pvNode) const;
+
+    // Extensions. Checks are extended while ply < 2 * rootDepth so check
+    // sequences can't run away. The TT move is extended when a reduced search
+    // excluding it fails SINGULAR_MARGIN_PER_PLY * depth below its TT score.
+    int rootDepth = 0;
+    static constexpr int SINGULAR_MIN_DEPTH = 6;
+    static constexpr double SINGULAR_MARGIN_PER_PLY = 0.02;
+
+    // Internal iterative deepening (PV nodes) / reduction (zero-window nodes)
+    // for nodes without a TT move
+    static constexpr int IIR_MIN_DEPTH = 4;
+
+    // Shallow-depth pruning (margins in pawns, indexed by remaining depth)
+    static constexpr int RFP_MAX_DEPTH = 3;
+    static constexpr double RFP_MARGIN_PER_PLY = 1.2;
+    static constexpr int FUTILITY_MAX_DEPTH = 3;
+    static constexpr double FUTILITY_MARGIN[FUTILITY_MAX_DEPTH + 1] = {0.0, 1.0, 1.8, 2.6};
+    static constexpr int LMP_MAX_DEPTH = 3;
+    static constexpr int LMP_MOVE_COUNT[LMP_MAX_DEPTH + 1] = {0, 5, 8, 13};
+
+    // Carry killers/history over to the next search of the same game
+    void ageHeuristics();
 
     // Helper functions
     void fastOrderMoves(vector<Move>& moves);  // Fast MVV-LVA ordering without making moves
-    void orderRootMoves(ChessGame& game, vector<Move>& moves); // Order root moves, preferring checks/mates
+    void orderRootMoves(ChessGame& game, vector<Move>& moves); // Order root moves, preferring checks
     vector<Move> generateCaptureMoves(ChessGame& game);  // Generate only capture moves for quiescence
     void orderMovesForSearch(ChessGame& game, vector<Move>& moves, int ply);
 
     // Search algorithm
     // 'ply' is the number of plies from the root (used to prefer shorter mates)
-    double alphabeta(ChessGame& game, int depth, double alpha, double beta, bool isMaximizing, bool allowNullMove = true, int ply = 0);
+    // 'excludedMove' (packed) is skipped at this node; used by the singular extension search
+    double alphabeta(ChessGame& game, int depth, double alpha, double beta, bool isMaximizing, bool allowNullMove = true, int ply = 0, uint32_t excludedMove = 0);
     double quiescence(ChessGame& game, double alpha, double beta, bool isMaximizing, int qDepth = 0);  // Quiescence search
     // Root mate prover: try to prove mate within maxDepth plies. If a mate is found,
     // returns true and sets outMove to the mating root move.
-    bool rootMateProver(ChessGame& game, int maxDepth, Move& outMove);
-    bool canForceMate(ChessGame& game, int depthLeft, bool attackerIsWhite);
+    // outPlies receives the length of the mating line.
+    bool rootMateProver(ChessGame& game, int maxDepth, Move& outMove, int& outPlies);
+    // Bounded mate search: attacker may only give check, defender tries every reply.
+    // Proofs/disproofs are cached per position; gives up after MATE_SEARCH_NODE_BUDGET nodes.
+    bool mateSearch(ChessGame& game, int depthLeft, bool attackerIsWhite);
+    static constexpr int MATE_SEARCH_MAX_PLIES = 9;          // mate in 5
+    static constexpr uint64_t MATE_SEARCH_NODE_BUDGET = 20000;
+    struct MateCacheEntry {
+        uint64_t key = 0;
+        int8_t proven = 0;       // mate proven within this many plies (0 = not proven)
+        int8_t disproven = -1;   // no checks-only mate within this many plies
+    };
+    std::vector<MateCacheEntry> mateCache;  // power-of-two sized, indexed by key
+    bool mateSearchAborted = false;
+    // Endgame tablebases (not owned). Probed below the root; at the root the
+    // move that keeps the tablebase result at the best distance is played.
+    const Tablebase* tablebase = nullptr;
+    uint64_t tbHits = 0;
+    // White-relative search score of a tablebase result 'ply' plies from the root
+    static double tablebaseScore(const TablebaseValue& value, bool whiteToMove, int ply);
+    bool rootTablebaseMove(ChessGame& game, const vector<Move>& moves, Move& bestMove, double& bestScore);
+    // Follow TT moves from the current position to extend a PV cut short by a TT hit (position is restored)
+    void collectPV(ChessGame& game, int maxLength, std::vector<Move>& pv);
+    void fillResultPV(ChessGame& game, int depth);
 
 public:
-    Engine();
-    Engine(const Evaluation& eval);
-    ~Engine() = default;
+    // Default transposition table size for interactive play / UCI
+    static constexpr size_t DEFAULT_HASH_MB = 256;
+    // Self-play games are short and many run at once; a small TT is plenty
+    static constexpr size_t SELFPLAY_HASH_MB = 16;
+
+    explicit BasicEngine(size_t hashMB = DEFAULT_HASH_MB);
+    explicit BasicEngine(const Eval& eval, size_t hashMB = DEFAULT_HASH_MB);
+    ~BasicEngine() = default;
 
     // Expose TT summary for diagnostics
     void printTTSummary() const;
 
-    // Profiling accessors (aggregate counters collected in engine.cpp)
+    // Profiling accessors (aggregate counters shared by all engines)
     static long long getTTLookupTime();   // microseconds
     static long long getEvalTime();       // microseconds
     static long long getMoveGenTime();    // microseconds
@@ -295,11 +558,48 @@ public:
 
     // Main public interface
     Move getBestMove(ChessGame& game, int depth);
+    // Time/node-limited search; returns the best move of the last completed iteration
+    Move getBestMove(ChessGame& game, const SearchLimits& limits);
+    // Score (white-relative) of one alphabeta search with the window (alpha, beta),
+    // without the root handling of getBestMove; for tests and analysis
+    double searchWindow(ChessGame& game, int depth, double alpha, double beta);
+    // Ask a running search to stop as soon as possible (safe to call from another thread)
+    void stop() { stopFlag.store(true, std::memory_order_relaxed); }
+    // Details of the most recent search
+    const SearchResult& getLastResult() const { return lastResult; }
+    // Called on the search thread after every completed iteration
+    void setInfoCallback(std::function<void(const SearchResult&)> callback) { infoCallback = std::move(callback); }
+    // Attach a statistics collector (nullptr detaches). It is reset at the start
+    // of every search; only filled in builds with ENGINE_SEARCH_STATS defined.
+    void setSearchStats(SearchStats* stats) { searchStats = stats; }
+    // Probe these endgame tablebases during search (nullptr detaches). They
+    // must outlive the engine's use of them.
+    void setTablebase(const Tablebase* tables) { tablebase = tables; }
+
+    // Hash table control (not safe while a search is running). largePages asks
+    // for transparent huge pages where the platform supports them.
+    void setHashSize(size_t sizeMB, bool largePages = false) { transpositionTable.init(sizeMB, largePages); }
+    size_t getHashSize() const { return transpositionTable.sizeMB(); }
+    void clearHash() { transpositionTable.clear(); }
+    // Forget everything learned in the previous game (TT, killers, history, PV move)
+    void newGame();
+    int hashfull() const { return transpositionTable.hashfull(); }
     // Set RNG seed used for root move randomization (opening variety)
     static void setRngSeed(uint64_t seed);
     
     // Optional: for debugging
     int nodesSearched = 0;
     int ttHits = 0;  // Transposition table hits
+
+private:
+    SearchResult lastResult;
+    std::function<void(const SearchResult&)> infoCallback;
+    SearchStats* searchStats = nullptr;
 };
 
+// The engine used by the console, GUI and UCI front-ends. Its member
+// definitions are compiled once in engine.cpp; include engine_impl.hpp to
+// instantiate BasicEngine with another evaluator.
+using Engine = BasicEngine<Evaluation>;
+extern template class BasicEngine<Evaluation>;
+
@@ -0,0 +1,1548 @@
+#pragma once
+// Definitions of BasicEngine's member templates. engine.cpp instantiates the
+// default Engine; tools that search with their own evaluator include this
+// header so their BasicEngine<TheirEval> gets compiled with it inlined.
+#include "engine.hpp"
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <cstddef>
+
+using namespace std;
+
+// Search statistics hooks: compiled out unless ENGINE_SEARCH_STATS is defined
+#ifdef ENGINE_SEARCH_STATS
+#define SEARCH_STAT(field) do { if (searchStats) searchStats->at(rootDepth).field++; } while (0)
+#else
+#define SEARCH_STAT(field) do {} while (0)
+#endif
+
+// Profiling counters
+inline long long ttLookupTime = 0;
+inline long long evalTime = 0;
+inline long long moveGenTime = 0;
+inline int ttLookupCalls = 0;
+inline int evalCalls = 0;
+inline int moveGenCalls = 0;
+// Make/undo counters
+inline long long makeMoveTime = 0;
+inline long long undoMoveTime = 0;
+inline int makeMoveCalls = 0;
+inline int undoMoveCalls = 0;
+
+// RNG for root move randomization (opening variety)
+inline std::mt19937 engineRng((uint32_t)std::chrono::steady_clock::now().time_since_epoch().count());
+
+// Piece captured by 'move' (EMPTY for quiet moves)
+inline int capturedPieceOf(const Move& move) {
+    if (move.moveType == EN_PASSANT) return board[move.startRow][move.targetColumn];
+    return board[move.targetRow][move.targetColumn];
+}
+
+// Material won outright by a capture/promotion, before any recapture
+inline double captureGain(const Move& move) {
+    double gain = seePieceValue(capturedPieceOf(move));
+    if (move.moveType == PAWN_PROMOTION) gain += seePieceValue(move.promotionPiece) - 1.0;
+    return gain;
+}
+
+// SEE < 0. Taking with a piece worth no more than the victim can never lose
+// material, so the full exchange is only evaluated for the other captures.
+inline bool isLosingCapture(const Move& move) {
+    int victim = capturedPieceOf(move);
+    int attacker = board[move.startRow][move.startColumn];
+    if (seePieceValue(victim) >= seePieceValue(attacker)) return false;
+    return staticExchangeEval(move) < 0.0;
+}
+
+// Base LMR reductions in plies, 1 + ln(depth) * ln(moveIndex) / 1.75, built once
+inline const int LMR_TABLE_SIZE = 64;
+inline const auto lmrTable = [] {
+    std::array<std::array<int, LMR_TABLE_SIZE>, LMR_TABLE_SIZE> t{};
+    for (int d = 1; d < LMR_TABLE_SIZE; d++) {
+        for (int m = 1; m < LMR_TABLE_SIZE; m++) {
+            t[d][m] = static_cast<int>(1.0 + std::log(d) * std::log(m) / 1.75);
+        }
+    }
+    return t;
+}();
+
+// Engine constructors: the TT is sized once here (self-play workers pass a small hashMB)
+template <class Eval>
+BasicEngine<Eval>::BasicEngine(size_t hashMB) : evaluator() {
+    transpositionTable.init(hashMB);
+    clearHeuristics();
+    pvLength.fill(0);
+}
+
+template <class Eval>
+BasicEngine<Eval>::BasicEngine(const Eval& eval, size_t hashMB) : evaluator(eval) {
+    transpositionTable.init(hashMB);
+    clearHeuristics();
+    pvLength.fill(0);
+}
+
+template <class Eval>
+void BasicEngine<Eval>::newGame() {
+    transpositionTable.clear();
+    evalHash.clear();
+    clearHeuristics();
+    mateCache.clear();
+    pvMove = Move(-1, -1, -1, -1);
+}
+
+// Forget all move-ordering statistics (killers, counters, history tables)
+template <class Eval>
+void BasicEngine<Eval>::clearHeuristics() {
+    for (auto &krow : killers) {
+        krow[0] = 0;
+        krow[1] = 0;
+    }
+    history.fill(0);
+    counterMoves.fill(0);
+    continuationHistory.assign(PIECE_TO_SIZE * PIECE_TO_SIZE, 0);
+    captureHistory.fill(0);
+    plyPieceTo.fill(-1);
+}
+
+// Between moves of one game: halve history so old cutoffs fade without being
+// forgotten, and shift killers two plies since the root moved forward a full move.
+template <class Eval>
+void BasicEngine<Eval>::ageHeuristics() {
+    for (auto &h : history) h /= 2;
+    for (auto &h : continuationHistory) h /= 2;
+    for (auto &h : captureHistory) h /= 2;
+    for (int ply = 0; ply + 2 < MAX_PLY; ++ply) killers[ply] = killers[ply + 2];
+    killers[MAX_PLY - 2] = {0, 0};
+    killers[MAX_PLY - 1] = {0, 0};
+}
+
+// Get the best move for the current position (fixed depth)
+template <class Eval>
+Move BasicEngine<Eval>::getBestMove(ChessGame& game, int depth) {
+    SearchLimits limits;
+    limits.depth = depth;
+    return getBestMove(game, limits);
+}
+
+// One search of 'game' with the window (alpha, beta) and no root handling
+// (iterative deepening, root ordering, mate prover, tablebase root move)
+template <class Eval>
+double BasicEngine<Eval>::searchWindow(ChessGame& game, int depth, double alpha, double beta) {
+    nodesSearched = 0;
+    proverNodes = 0;
+    tbHits = 0;
+    ttHits = 0;
+    setupLimits(SearchLimits(), game.isWhiteToMove());
+    transpositionTable.newSearch();
+#ifdef ENGINE_SEARCH_STATS
+    if (searchStats) searchStats->reset();
+#endif
+    rootDepth = depth;
+    followPV = false;
+    double score = alphabeta(game, depth, alpha, beta, game.isWhiteToMove(), true, 0);
+    game.clearUndoStack();
+    return score;
+}
+
+// Elapsed time since the current search started
+template <class Eval>
+long long BasicEngine<Eval>::elapsedMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count();
+}
+
+// Translate UCI-style limits into a soft limit (don't start another iteration)
+// and a hard limit (abort the running iteration).
+template <class Eval>
+void BasicEngine<Eval>::setupLimits(const SearchLimits& limits, bool whiteToMove) {
+    searchStart = std::chrono::steady_clock::now();
+    stopFlag.store(false, std::memory_order_relaxed);
+    searchAborted = false;
+    nodeLimit = limits.nodes;
+    softLimitMs = 0;
+    hardLimitMs = 0;
+    if (limits.infinite) return;
+
+    if (limits.movetimeMs > 0) {
+        softLimitMs = limits.movetimeMs;
+        hardLimitMs = limits.movetimeMs;
+        return;
+    }
+
+    long long timeLeft = whiteToMove ? limits.wtimeMs : limits.btimeMs;
+    long long inc = whiteToMove ? limits.wincMs : limits.bincMs;
+    if (timeLeft <= 0) return;
+
+    const long long MOVE_OVERHEAD_MS = 30;  // reserve for I/O and move transmission
+    long long usable = std::max(1LL, timeLeft - MOVE_OVERHEAD_MS);
+    int movesToGo = (limits.movestogo > 0) ? std::min(limits.movestogo, 50) : 30;
+
+    softLimitMs = usable / movesToGo + inc * 3 / 4;
+    // Never spend more than a third of the remaining clock on one move
+    hardLimitMs = std::min(usable / 3, softLimitMs * 4);
+    softLimitMs = std::max(1LL, std::min(softLimitMs, hardLimitMs));
+    hardLimitMs = std::max(1LL, hardLimitMs);
+}
+
+// Returns true once the search must unwind (stop requested, node or time budget spent)
+template <class Eval>
+bool BasicEngine<Eval>::checkLimits() {
+    if (searchAborted) return true;
+    uint64_t nodes = (uint64_t)nodesSearched + proverNodes;
+    if (stopFlag.load(std::memory_order_relaxed)) {
+        searchAborted = true;
+    } else if (nodeLimit > 0 && nodes >= nodeLimit) {
+        searchAborted = true;
+    } else if (hardLimitMs > 0 && (nodes & 1023) == 0 && elapsedMs() >= hardLimitMs) {
+        searchAborted = true;
+    }
+    return searchAborted;
+}
+
+// Get the best move under time/node limits
+template <class Eval>
+Move BasicEngine<Eval>::getBestMove(ChessGame& game, const SearchLimits& limits) {
+    nodesSearched = 0;  // Reset counter at start of search
+    proverNodes = 0;
+    tbHits = 0;
+    ttHits = 0;  // Reset TT hits counter
+    setupLimits(limits, game.isWhiteToMove());
+    lastResult = SearchResult();
+    transpositionTable.newSearch();
+#ifdef ENGINE_SEARCH_STATS
+    if (searchStats) searchStats->reset();
+#endif
+    ageHeuristics();
+    // The previous search's best move belongs to another position; seed the PV
+    // move from the TT instead (it is there if this position was in the last PV)
+    pvMove = Move(-1, -1, -1, -1);
+    prevPV.clear();
+    followPV = false;
+    TTEntry rootEntry;
+    if (transpositionTable.probe(game.getZobristHash(), rootEntry) && rootEntry.packedMove != 0) {
+        pvMove = unpackMove(rootEntry.packedMove);
+    }
+    int depth = (limits.depth > 0) ? std::min(limits.depth, MAX_SEARCH_DEPTH) : MAX_SEARCH_DEPTH;
+
+    
+    vector<Move> legalMoves = game.getLegalMoves();
+    
+    if (legalMoves.empty()) {
+        return Move(-1, -1, -1, -1); // No legal moves
+    }
+    
+    // getLegalMoves() already filters moves that leave our king in check. (The old
+    // make/isInCheck filter here tested the opponent's king and so threw away
+    // every checking move at the root.)
+    vector<Move> validatedMoves = legalMoves;
+    // Shuffle validated moves at root to vary opening choices between games
+    // TEMPORARILY DISABLED for testing - shuffle randomizes even with good eval!
+    // std::shuffle(validatedMoves.begin(), validatedMoves.end(), engineRng);
+    // Order validated moves at root using MVV-LVA so captures/promotions are searched early.
+    // This is a cheap sort on the root move list (normally ~20-40 moves) and actually
+    // helps pruning—it's negligible compared to the cost of search and usually speeds it up.
+    // Use a root-specific ordering which promotes checks/mates above captures
+    // Initial root ordering so the first iteration searches checks/mates early
+    // A tablebase position needs no search: play the move that keeps the result
+    Move tbMove(-1, -1, -1, -1);
+    double tbScore = 0.0;
+    if (tablebase && rootTablebaseMove(game, validatedMoves, tbMove, tbScore)) {
+        game.clearUndoStack();
+        lastResult.bestMove = tbMove;
+        lastResult.score = tbScore;
+        lastResult.depth = 1;
+        lastResult.nodes = nodesSearched + proverNodes;
+        lastResult.tbHits = tbHits;
+        lastResult.timeMs = elapsedMs();
+        lastResult.pv.assign(1, tbMove);
+        if (infoCallback) infoCallback(lastResult);
+        return tbMove;
+    }
+    // First, try a bounded checks-only mate search to quickly detect forced mates.
+    // Quiet-move mates are left to the main search and its mate-distance TT scores.
+    Move mateMove(-1,-1,-1,-1);
+    int matePlies = 0;
+    int mateProverDepth = (limits.depth > 0) ? std::min(depth, MATE_SEARCH_MAX_PLIES) : MATE_SEARCH_MAX_PLIES;
+    if (mateProverDepth > 0 && rootMateProver(game, mateProverDepth, mateMove, matePlies)) {
+        game.clearUndoStack();
+        const double MATE_SCORE = 100000.0;
+        lastResult.bestMove = mateMove;
+        lastResult.score = game.isWhiteToMove() ? (MATE_SCORE - matePlies) : -(MATE_SCORE - matePlies);
+        lastResult.depth = matePlies;
+        lastResult.nodes = nodesSearched + proverNodes;
+        lastResult.tbHits = tbHits;
+        lastResult.timeMs = elapsedMs();
+        lastResult.pv.assign(1, mateMove);
+        if (infoCallback) infoCallback(lastResult);
+        return mateMove; // Found a forced mate at root; return immediately
+    }
+
+    // Otherwise, perform normal root ordering
+    orderRootMoves(game, validatedMoves);
+    
+    bool isWhiteTurn = game.isWhiteToMove();
+    Move bestMove = validatedMoves[0];
+    double bestScore = 0.0;
+    
+    // ITERATIVE DEEPENING: Search from depth 1 to target depth
+    for (int currentDepth = 1; currentDepth <= depth && !searchAborted; currentDepth++) {
+        // Soft limit: an iteration we can't finish is wasted work
+        if (currentDepth > 1 && softLimitMs > 0 && elapsedMs() >= softLimitMs) break;
+        rootDepth = currentDepth;
+        
+        // Move pvMove to front of list if it's valid (for better move ordering)
+        if (pvMove.startRow != -1) {
+            auto it = find_if(validatedMoves.begin(), validatedMoves.end(), 
+                [this](const Move& m) {
+                    return m.startRow == pvMove.startRow && 
+                           m.startColumn == pvMove.startColumn &&
+                           m.targetRow == pvMove.targetRow && 
+                           m.targetColumn == pvMove.targetColumn;
+                });
+            if (it != validatedMoves.end()) {
+                // Swap pvMove to front
+                Move temp = *it;
+                validatedMoves.erase(it);
+                validatedMoves.insert(validatedMoves.begin(), temp);
+            }
+        }
+            // Re-apply root ordering to the remaining moves (keep PV pinned at index 0)
+            if (validatedMoves.size() > 1) {
+                // Order only the moves after the PV to preserve PV stability
+                vector<Move> remainder(validatedMoves.begin() + 1, validatedMoves.end());
+                orderRootMoves(game, remainder);
+                // copy reordered remainder back into validatedMoves
+                for (size_t i = 0; i < remainder.size(); ++i) {
+                    validatedMoves[i + 1] = remainder[i];
+                }
+            }
+        
+        // White wants to maximize evaluation, black to minimize
+        Move iterationBest = validatedMoves[0];
+        double iterationBestEval = isWhiteTurn ? -numeric_limits<double>::infinity()
+                                               : numeric_limits<double>::infinity();
+        vector<uint32_t> iterationPV;
+        bool firstMoveDone = false;
+        // Root window: later moves only have to prove they beat the best so far
+        double rootAlpha = -numeric_limits<double>::infinity();
+        double rootBeta = numeric_limits<double>::infinity();
+
+        for (size_t i = 0; i < validatedMoves.size(); ++i) {
+            const Move& move = validatedMoves[i];
+            // Only the first root move can continue the previous iteration's PV
+            followPV = (i == 0 && !prevPV.empty() && prevPV[0] == packMove(move));
+            plyPieceTo[0] = pieceTo(board[move.startRow][move.startColumn], move.targetRow * 8 + move.targetColumn);
+            game.makeMoveForEngine(move);
+            
+            double eval = alphabeta(game, currentDepth - 1, rootAlpha, rootBeta, !isWhiteTurn, true, 1);
+            
+            game.undoMove();
+            if (searchAborted) break;
+            firstMoveDone = true;
+
+            if (isWhiteTurn ? (eval > iterationBestEval) : (eval < iterationBestEval)) {
+                iterationBestEval = eval;
+                iterationBest = move;
+                iterationPV.assign(1, packMove(move));
+                iterationPV.insert(iterationPV.end(), pvTable[1].begin() + 1, pvTable[1].begin() + pvLength[1]);
+                if (isWhiteTurn) rootAlpha = eval; else rootBeta = eval;
+            }
+        }
+        followPV = false;
+
+        if (searchAborted) {
+            // The previous best move is searched first; once it has a score at this
+            // depth, any move that beat it is at least as good as what we have.
+            if (firstMoveDone) {
+                bestMove = iterationBest;
+                bestScore = iterationBestEval;
+                prevPV = iterationPV;
+            }
+            break;
+        }
+
+        bestMove = iterationBest;
+        bestScore = iterationBestEval;
+        prevPV = iterationPV;
+        lastResult.depth = currentDepth;
+#ifdef ENGINE_SEARCH_STATS
+        if (searchStats) {
+            searchStats->at(currentDepth).timeMs = elapsedMs();
+            searchStats->at(currentDepth).completed = true;
+        }
+#endif
+        
+        // Update pvMove for next iteration
+        pvMove = bestMove;
+
+        // Keep the root in the TT too so the next search of this game can seed its PV move
+        {
+            const double MATE_SCORE = 100000.0;
+            int mateDist = 0;
+            if (std::abs(bestScore) >= (MATE_SCORE - 1000.0)) {
+                mateDist = static_cast<int>(std::round(MATE_SCORE - std::abs(bestScore)));
+            }
+            transpositionTable.store(game.getZobristHash(), bestScore, currentDepth, TTBound::EXACT, mateDist, packMove(bestMove));
+        }
+
+        if (infoCallback) {
+            lastResult.bestMove = bestMove;
+            lastResult.score = bestScore;
+            lastResult.nodes = nodesSearched + proverNodes;
+            lastResult.tbHits = tbHits;
+            lastResult.timeMs = elapsedMs();
+            fillResultPV(game, currentDepth);
+            infoCallback(lastResult);
+        }
+    }
+    
+    // Clear undo stack after search is complete
+    game.clearUndoStack();
+
+    lastResult.bestMove = bestMove;
+    lastResult.score = bestScore;
+    lastResult.nodes = nodesSearched + proverNodes;
+    lastResult.tbHits = tbHits;
+    lastResult.timeMs = elapsedMs();
+    fillResultPV(game, std::max(1, lastResult.depth));
+    
+    // Print profiling results (commented out for cleaner output)
+    // cout << "\n=== PROFILING RESULTS ===" << endl;
+    // cout << "TT Lookups: " << ttLookupCalls << " calls, " 
+    //      << (ttLookupTime / 1000.0) << " ms (" 
+    //      << (ttLookupTime / (double)ttLookupCalls / 1000.0) << " ms avg)" << endl;
+    // cout << "Evaluations: " << evalCalls << " calls, " 
+    //      << (evalTime / 1000.0) << " ms (" 
+    //      << (evalTime / (double)evalCalls / 1000.0) << " ms avg)" << endl;
+    // cout << "Move Generation: " << moveGenCalls << " calls, " 
+    //      << (moveGenTime / 1000.0) << " ms (" 
+    //      << (moveGenTime / (double)moveGenCalls / 1000.0) << " ms avg)" << endl;
+    // cout << "Total Profiled: " 
+    //      << ((ttLookupTime + evalTime + moveGenTime) / 1000.0) << " ms" << endl;
+    // cout << "TT Table Size: " << transpositionTable.size() << " unique positions" << endl;
+    // cout << "=========================" << endl;
+    
+    return bestMove;
+}
+
+// Mate distances from the tablebase become ordinary mate scores, so they mix
+// with mates found by search and keep their distance through the TT
+template <class Eval>
+double BasicEngine<Eval>::tablebaseScore(const TablebaseValue& value, bool whiteToMove, int ply) {
+    const double MATE_SCORE = 100000.0;
+    if (value.wdl == 0) return 0.0;
+    double score = MATE_SCORE - (ply + value.plies);
+    return (value.wdl > 0) == whiteToMove ? score : -score;
+}
+
+// If the root is in the tablebases, pick the move reaching the best child:
+// the quickest mate when winning, any draw when drawn, the slowest mate when
+// losing. False if the root or the child holding its result can't be probed
+// (castling or en passant rights), and the normal search runs instead.
+template <class Eval>
+bool BasicEngine<Eval>::rootTablebaseMove(ChessGame& game, const vector<Move>& moves, Move& bestMove, double& bestScore) {
+    TablebaseValue root;
+    if (!tablebase->probe(game, root)) return false;
+    tbHits++;
+    const bool whiteToMove = game.isWhiteToMove();
+    int bestRank = std::numeric_limits<int>::min();
+    for (const Move& move : moves) {
+        game.makeMoveForEngine(move);
+        TablebaseValue child;
+        bool found = tablebase->probe(game, child);
+        game.undoMove();
+        if (!found) continue;
+        tbHits++;
+        // Preference for the mover: quicker wins, then draws, then slower losses
+        int rank = child.wdl < 0 ? 100000 - child.plies : (child.wdl > 0 ? -100000 + child.plies : 0);
+        if (rank > bestRank) {
+            bestRank = rank;
+            bestMove = move;
+            bestScore = tablebaseScore(child, !whiteToMove, 1);
+        }
+    }
+    int achieved = bestRank > 0 ? 1 : (bestRank < 0 ? -1 : 0);
+    return bestRank != std::numeric_limits<int>::min() && achieved == root.wdl;
+}
+
+// Fast move ordering using MVV-LVA (Most Valuable Victim - Least Valuable Attacker)
+// No make/undo moves - just looks at the board state
+template <class Eval>
+void BasicEngine<Eval>::fastOrderMoves(vector<Move>& moves) {
+    struct MoveScore { Move move; int score; };
+    vector<MoveScore> scoredMoves;
+    scoredMoves.reserve(moves.size());
+    
+    for (const Move& move : moves) {
+        int score = 0;
+        
+        // Detect capture by inspecting the board square at the target
+        int capturedPiece = EMPTY;
+        if (move.moveType == EN_PASSANT) {
+            capturedPiece = board[move.startRow][move.targetColumn];
+        } else {
+            capturedPiece = board[move.targetRow][move.targetColumn];
+        }
+        
+        int movingPiece = board[move.startRow][move.startColumn];
+        
+        if (!isEmpty(capturedPiece)) {
+            // MVV-LVA: (Victim value * 10) - Attacker value
+            // This prioritizes capturing valuable pieces with less valuable pieces
+            int victimValue = 0;
+            int attackerValue = 0;
+            
+            int victimType = capturedPiece & 0b0111;
+            int attackerType = movingPiece & 0b0111;
+            
+            switch(victimType) {
+                case 0b0001: victimValue = 1; break;  // pawn
+                case 0b0011: victimValue = 3; break;  // knight
+                case 0b0100: victimValue = 3; break;  // bishop
+                case 0b0010: victimValue = 5; break;  // rook
+                case 0b0101: victimValue = 9; break;  // queen
+                default: victimValue = 0; break;
+            }
+            
+            switch(attackerType) {
+                case 0b0001: attackerValue = 1; break;  // pawn
+                case 0b0011: attackerValue = 3; break;  // knight
+                case 0b0100: attackerValue = 3; break;  // bishop
+                case 0b0010: attackerValue = 5; break;  // rook
+                case 0b0101: attackerValue = 9; break;  // queen
+                case 0b0110: attackerValue = 10; break; // king (discourage king captures)
+                default: attackerValue = 0; break;
+            }
+            
+            // Captures: higher score for better MVV-LVA
+            score = 1000 + (victimValue * 10) - attackerValue;
+        }
+        // Promotions are also valuable
+        else if (move.moveType == PAWN_PROMOTION) {
+            score = 900;  // High priority
+        }
+        // Quiet moves get low priority
+        else {
+            score = 0;
+        }
+        
+        scoredMoves.push_back({move, score});
+    }
+    
+    // Sort descending by score
+    sort(scoredMoves.begin(), scoredMoves.end(), [](const MoveScore& a, const MoveScore& b) {
+        return a.score > b.score;
+    });
+    
+    // Copy back
+    moves.clear();
+    for (const auto& ms : scoredMoves) {
+        moves.push_back(ms.move);
+    }
+}
+
+// Generate only capture moves for quiescence search
+template <class Eval>
+vector<Move> BasicEngine<Eval>::generateCaptureMoves(ChessGame& game) {
+    auto mgStart = std::chrono::high_resolution_clock::now();
+    vector<Move> allMoves = game.getLegalMoves();
+    auto mgEnd = std::chrono::high_resolution_clock::now();
+    moveGenTime += std::chrono::duration_cast<std::chrono::microseconds>(mgEnd - mgStart).count();
+    moveGenCalls++;
+    vector<Move> captures;
+    captures.reserve(allMoves.size());
+    for (const Move& move : allMoves) {
+        // Check if it's a capture
+        int capturedPiece = EMPTY;
+        if (move.moveType == EN_PASSANT) {
+            capturedPiece = board[move.startRow][move.targetColumn];
+        } else {
+            capturedPiece = board[move.targetRow][move.targetColumn];
+        }
+        
+        // Include captures and promotions (promotions are also tactical)
+        if (!isEmpty(capturedPiece) || move.moveType == PAWN_PROMOTION) {
+            captures.push_back(move);
+        }
+    }
+    
+    return captures;
+}
+
+// Quiescence search - search tactical moves until position is quiet
+template <class Eval>
+double BasicEngine<Eval>::quiescence(ChessGame& game, double alpha, double beta, bool isMaximizing, int qDepth) {
+    nodesSearched++;  // Count this node
+    SEARCH_STAT(qnodes);
+    if (checkLimits()) return 0.0;  // result is discarded by the root
+    
+    // Limit quiescence depth to prevent explosion (more aggressive limit)
+    const int MAX_QUIESCENCE_DEPTH = 6;
+    // don't store quiescence-only results here (store-filter: depth >= 1 required)
+    uint64_t posKey = game.getZobristHash();
+
+    // Stand pat score - the evaluation if we don't make any more captures
+    // Outside (alpha, beta) only a bound is needed: lazy eval returns one on the
+    // safe side for the stand-pat cutoff and delta pruning below
+    double standPat = evaluateCached(game, alpha, beta);
+    if (qDepth >= MAX_QUIESCENCE_DEPTH) return standPat;
+    
+    if (isMaximizing) {
+        // Can we already improve alpha without searching?
+        if (standPat >= beta) {
+            return beta;  // Beta cutoff
+        }
+        if (standPat > alpha) {
+            alpha = standPat;  // Improve alpha
+        }
+    } else {
+        // Can we already improve beta without searching?
+        if (standPat <= alpha) {
+            return alpha;  // Alpha cutoff
+        }
+        if (standPat < beta) {
+            beta = standPat;  // Improve beta
+        }
+    }
+    
+    // Generate and search only capture moves
+    vector<Move> captureMoves = generateCaptureMoves(game);
+    
+    // If no captures, position is quiet - return stand pat
+    if (captureMoves.empty()) {
+        // do not store stand-pat (depth 0) to avoid noisy shallow entries
+        return standPat;
+    }
+    
+    // Order captures by MVV-LVA
+    fastOrderMoves(captureMoves);
+    
+    // Delta pruning threshold - biggest possible material gain (queen = 9)
+    const double BIG_DELTA = 9.0 + 1.0;  // Queen value + safety margin
+    const double DELTA_MARGIN = 2.0;      // positional swing allowed on top of a single capture
+    
+    if (isMaximizing) {
+        double maxEval = standPat;
+        
+        // Delta pruning - if even capturing a queen can't improve alpha, skip search
+        if (standPat + BIG_DELTA < alpha) {
+            return alpha;
+        }
+        
+        for (const Move& move : captureMoves) {
+            // Delta pruning per capture: winning this piece plus a positional
+            // margin still can't raise alpha
+            if (standPat + captureGain(move) + DELTA_MARGIN < alpha) continue;
+            // Captures that lose material in the exchange can't improve on standing pat
+            if (isLosingCapture(move)) continue;
+            game.makeMoveForEngine(move);
+            double eval = quiescence(game, alpha, beta, false, qDepth + 1);
+            game.undoMove();
+            if (searchAborted) return 0.0;
+            
+            maxEval = max(maxEval, eval);
+            alpha = max(alpha, eval);
+            if (beta <= alpha) {
+                break;  // Beta cutoff
+            }
+        }
+        return maxEval;
+        
+    } else {
+        double minEval = standPat;
+        
+        // Delta pruning - if even capturing a queen can't improve beta, skip search
+        if (standPat - BIG_DELTA > beta) {
+            return beta;
+        }
+        
+        for (const Move& move : captureMoves) {
+            if (standPat - captureGain(move) - DELTA_MARGIN > beta) continue;
+            if (isLosingCapture(move)) continue;
+            game.makeMoveForEngine(move);
+            double eval = quiescence(game, alpha, beta, true, qDepth + 1);
+            game.undoMove();
+            if (searchAborted) return 0.0;
+            
+            minEval = min(minEval, eval);
+            beta = min(beta, eval);
+            if (beta <= alpha) {
+                break;  // Alpha cutoff
+            }
+        }
+        return minEval;
+    }
+}
+
+// Alpha-beta pruning (optimized minimax)
+template <class Eval>
+double BasicEngine<Eval>::alphabeta(ChessGame& game, int depth, double alpha, double beta, bool isMaximizing, bool allowNullMove, int ply, uint32_t excludedMove) {
+    nodesSearched++;  // Count this node
+    SEARCH_STAT(nodes);
+    // Zero-window nodes only decide whether a move beats the bound. Decided on
+    // the window the caller passed, with slack: alpha + ZERO_WINDOW - alpha
+    // rounds either way once scores are a few pawns
+    const bool pvNode = (beta - alpha) > 1.5 * ZERO_WINDOW;
+    if (!pvNode) SEARCH_STAT(nonPvNodes);
+    // Unwind immediately once a limit is hit; nothing below stores partial results
+    if (checkLimits()) return 0.0;
+    if (ply >= MAX_PLY - 1) return quiescence(game, alpha, beta, isMaximizing);
+    pvLength[ply] = ply;
+    // Neither side can mate: nothing to search (a material-key test, cheap)
+    if (ply > 0 && game.isDrawByInsufficientMaterial()) return 0.0;
+    // Exact result from the endgame tablebases
+    if (tablebase && ply > 0 && excludedMove == 0) {
+        TablebaseValue tb;
+        if (tablebase->probe(game, tb)) {
+            tbHits++;
+            return tablebaseScore(tb, game.isWhiteToMove(), ply);
+        }
+    }
+    
+    // Check transposition table BEFORE generating moves (expensive operation)
+    auto ttStart = std::chrono::high_resolution_clock::now();
+    uint64_t posKey = game.getZobristHash();
+    TTEntry ttEntry;
+    bool ttFound = transpositionTable.probe(posKey, ttEntry);
+    auto ttEnd = std::chrono::high_resolution_clock::now();
+    ttLookupTime += std::chrono::duration_cast<std::chrono::microseconds>(ttEnd - ttStart).count();
+    ttLookupCalls++;
+    
+    // Use TT entry if it was searched at equal or greater depth
+    // (A position searched deeper is more accurate). The entry describes the
+    // full node, so it can't answer a search that excludes a move.
+    if (ttFound && ttEntry.depth >= depth && excludedMove == 0) {
+        ttHits++;
+        double stored = ttEntry.score;
+        // Ignore entries with non-finite scores (defensive)
+        if (!std::isfinite(stored)) {
+            // fall through and search normally
+        } else {
+            const double MATE_SCORE = 100000.0;
+            // If the entry encodes a mate-in-N from that position, reconstruct
+            // the score for the current 'ply' so mate-distance is preserved.
+            if (ttEntry.mateDistance > 0 && std::abs(stored) >= (MATE_SCORE - 1000.0)) {
+                int D = ttEntry.mateDistance; // plies from stored position to mate
+                // Reconstruct a score relative to current ply: score = sign * (MATE_SCORE - (ply + D))
+                double sign = (stored > 0.0) ? 1.0 : -1.0;
+                double adjusted = sign * (MATE_SCORE - (ply + D));
+
+                if (ttEntry.bound == TTBound::EXACT) {
+                    return adjusted;
+                } else if (ttEntry.bound == TTBound::LOWER) {
+                    if (adjusted > alpha) alpha = adjusted;
+                    if (alpha >= beta) return adjusted;
+                } else if (ttEntry.bound == TTBound::UPPER) {
+                    if (adjusted < beta) beta = adjusted;
+                    if (alpha >= beta) return adjusted;
+                }
+            } else {
+                // Non-mate entries: use previous bound-aware logic
+                if (ttEntry.bound == TTBound::EXACT) {
+                    return stored;
+                } else if (ttEntry.bound == TTBound::LOWER) {
+                    // Stored score is a lower bound: true score >= stored
+                    if (stored > alpha) alpha = stored;
+                    if (alpha >= beta) return stored;
+                } else if (ttEntry.bound == TTBound::UPPER) {
+                    // Stored score is an upper bound: true score <= stored
+                    if (stored < beta) beta = stored;
+                    if (alpha >= beta) return stored;
+                }
+            }
+        }
+    }
+    
+    if(depth == 0){
+        // Instead of static eval, call quiescence search to resolve captures
+        return quiescence(game, alpha, beta, isMaximizing);
+    }
+    
+    // Do not prune if TT indicates a mate is nearby: pruning can irreversibly
+    // cut mate lines.
+    bool ttIndicatesMate = (ttFound && ttEntry.mateDistance > 0);
+    // Side to move in check? Computed once per node
+    const bool inCheck = game.isInCheck();
+    // The bound this side is trying to beat ("cut") and the one it must reach
+    const double cutBound = isMaximizing ? beta : alpha;
+    const double improveBound = isMaximizing ? alpha : beta;
+    const double MATE_BOUND = 100000.0 - 1000.0;
+    auto isPlainBound = [&](double b) { return std::isfinite(b) && std::abs(b) < MATE_BOUND; };
+    const bool canPrune = !inCheck && !ttIndicatesMate && excludedMove == 0;
+
+    // Static eval drives all pruning below; not needed (or meaningful) in check
+    double staticEval = 0.0;
+    if (canPrune) {
+        if (ttFound && !std::isnan(ttEntry.staticEval)) {
+            staticEval = ttEntry.staticEval;
+            ttStaticEvalHits++;
+        } else {
+            staticEval = evaluateCached(game);
+        }
+    }
+    // Handed to the TT with this node's result so later visits skip evaluation
+    const double storedStaticEval = canPrune ? staticEval : std::numeric_limits<double>::quiet_NaN();
+    // Static eval from the side to move's point of view
+    const double stmEval = isMaximizing ? staticEval : -staticEval;
+
+    // REVERSE FUTILITY PRUNING (static null move)
+    // Near the leaves, if we're so far past the cut bound that even a margin
+    // per remaining ply can't bring the score back, fail high immediately.
+    if (canPrune && !pvNode && depth <= RFP_MAX_DEPTH && isPlainBound(cutBound)) {
+        double margin = RFP_MARGIN_PER_PLY * depth;
+        if (isMaximizing && staticEval - margin >= beta) return staticEval - margin;
+        if (!isMaximizing && staticEval + margin <= alpha) return staticEval + margin;
+    }
+
+    // NULL MOVE PRUNING
+    // Give the opponent a free move - if we're still past the cut bound, cut off early
+    const int NULL_MOVE_REDUCTION = 3;  // Search 3 plies less
+    if (allowNullMove && !followPV && depth >= NULL_MOVE_REDUCTION + 1 && canPrune &&
+        isPlainBound(cutBound) && (isMaximizing ? staticEval >= beta : staticEval <= alpha)) {
+        SEARCH_STAT(nullMoveTries);
+        plyPieceTo[ply] = -1;
+        game.makeNullMove();
+        // Zero window just inside the cut bound: only "still past it?" matters
+        double nullScore = isMaximizing
+            ? alphabeta(game, depth - 1 - NULL_MOVE_REDUCTION, beta - ZERO_WINDOW, beta, false, false, ply+1)
+            : alphabeta(game, depth - 1 - NULL_MOVE_REDUCTION, alpha, alpha + ZERO_WINDOW, true, false, ply+1);
+        game.undoNullMove();
+        if (searchAborted) return 0.0;
+
+        if (isMaximizing && nullScore >= beta) { SEARCH_STAT(nullMoveCutoffs); return beta; }
+        if (!isMaximizing && nullScore <= alpha) { SEARCH_STAT(nullMoveCutoffs); return alpha; }
+    }
+
+    // FUTILITY PRUNING
+    // At frontier nodes whose static eval plus a margin can't reach the bound
+    // this side must improve, quiet moves are skipped (see the move loops).
+    const bool futileNode = canPrune && depth <= FUTILITY_MAX_DEPTH && isPlainBound(improveBound) &&
+                            stmEval + FUTILITY_MARGIN[depth] <= (isMaximizing ? alpha : -beta);
+    const double futilityValue = isMaximizing ? staticEval + FUTILITY_MARGIN[std::min(depth, FUTILITY_MAX_DEPTH)]
+                                              : staticEval - FUTILITY_MARGIN[std::min(depth, FUTILITY_MAX_DEPTH)];
+    // LATE MOVE PRUNING: at shallow depth, quiet moves this late are not searched at all
+    const bool lmpNode = canPrune && !pvNode && depth <= LMP_MAX_DEPTH && isPlainBound(improveBound);
+
+    // INTERNAL ITERATIVE DEEPENING / REDUCTION
+    // Without a hash move the node would be ordered by heuristics alone. At PV
+    // nodes a shallower search of this node seeds the TT with a best move; at
+    // zero-window nodes the node is just searched one ply shallower.
+    if (!(ttFound && ttEntry.packedMove != 0) && excludedMove == 0 && !followPV && depth >= IIR_MIN_DEPTH) {
+        if (pvNode) {
+            alphabeta(game, depth - 2, alpha, beta, isMaximizing, false, ply);
+            if (searchAborted) return 0.0;
+            pvLength[ply] = ply;
+            ttFound = transpositionTable.probe(posKey, ttEntry);
+        } else {
+            depth--;
+        }
+    }
+
+    auto moveGenStart = std::chrono::high_resolution_clock::now();
+    vector<Move> legalmoves = game.getLegalMoves();
+    auto moveGenEnd = std::chrono::high_resolution_clock::now();
+    moveGenTime += std::chrono::duration_cast<std::chrono::microseconds>(moveGenEnd - moveGenStart).count();
+    moveGenCalls++;
+    
+    // If no legal moves, it's checkmate or stalemate
+    if(legalmoves.empty()) {
+        double eval;
+        if(inCheck) {
+            // Checkmate: return extreme values but prefer shorter mates
+            const double MATE_SCORE = 100000.0;
+            // 'ply' is the number of plies from the root to this node
+            // If current side is checkmated (isMaximizing true), return a large negative
+            // value increased by ply so that shorter mate (smaller ply) is worse.
+            eval = isMaximizing ? (-MATE_SCORE + ply) : (MATE_SCORE - ply);
+        } else {
+            // Stalemate: penalize if we're winning, reward if we're losing
+            // This makes the engine avoid stalemate when ahead and seek it when behind
+            double materialScore = evaluator.materialCount(game);
+            // If we're ahead (positive material), stalemate is BAD (-5000)
+            // If we're behind (negative material), stalemate is GOOD (+5000)
+            // The penalty/reward is proportional to material advantage
+            eval = -materialScore * 500.0;  // Scale the penalty
+        }
+        // Store terminal nodes in TT as exact evaluations (depth 0) only if we're at non-quiescence depth
+        if (depth >= 1) {
+            transpositionTable.store(posKey, eval, 0, TTBound::EXACT, 0);
+        }
+        return eval;
+    }
+    
+    // Cheap ordering without making moves: SEE-split captures, killers, history
+    orderMovesForSearch(game, legalmoves, ply);
+    // If transposition table suggests a best move, promote it to the front
+    bool ttMoveLegal = false;
+    if (ttFound && ttEntry.packedMove != 0) {
+        Move ttMove = unpackMove(ttEntry.packedMove);
+        auto ittt = find_if(legalmoves.begin(), legalmoves.end(), [&](const Move &m){
+            return m.startRow == ttMove.startRow && m.startColumn == ttMove.startColumn &&
+                   m.targetRow == ttMove.targetRow && m.targetColumn == ttMove.targetColumn &&
+                   m.moveType == ttMove.moveType;
+        });
+        if (ittt != legalmoves.end()) {
+            ttMoveLegal = true;
+            Move tmp = *ittt;
+            legalmoves.erase(ittt);
+            legalmoves.insert(legalmoves.begin(), tmp);
+        }
+    }
+    // While this path follows the previous iteration's PV, its next move goes first
+    if (followPV) {
+        followPV = false;
+        if (ply < (int)prevPV.size()) {
+            uint32_t pvPacked = prevPV[ply];
+            auto itpv = find_if(legalmoves.begin(), legalmoves.end(), [pvPacked](const Move &m){
+                return packMove(m) == pvPacked;
+            });
+            if (itpv != legalmoves.end()) {
+                std::rotate(legalmoves.begin(), itpv, itpv + 1);
+                followPV = true;
+            }
+        }
+    }
+    
+    // SINGULAR EXTENSION
+    // A TT move whose score came from a search deep enough to trust is verified
+    // by a reduced zero-window search of the other moves. If none of them gets
+    // close, the TT move is the only good move and is searched one ply deeper.
+    bool ttMoveSingular = false;
+    if (ttMoveLegal && excludedMove == 0 && ply > 0 && depth >= SINGULAR_MIN_DEPTH &&
+        ttEntry.depth >= depth - 3 && ttEntry.mateDistance == 0 && std::isfinite(ttEntry.score) &&
+        ttEntry.bound != (isMaximizing ? TTBound::UPPER : TTBound::LOWER)) {
+        double margin = SINGULAR_MARGIN_PER_PLY * depth;
+        bool savedFollowPV = followPV;
+        followPV = false;
+        if (isMaximizing) {
+            double singularBeta = ttEntry.score - margin;
+            double score = alphabeta(game, (depth - 1) / 2, singularBeta - ZERO_WINDOW, singularBeta,
+                                     true, false, ply, ttEntry.packedMove);
+            ttMoveSingular = score < singularBeta;
+        } else {
+            double singularAlpha = ttEntry.score + margin;
+            double score = alphabeta(game, (depth - 1) / 2, singularAlpha, singularAlpha + ZERO_WINDOW,
+                                     false, false, ply, ttEntry.packedMove);
+            ttMoveSingular = score > singularAlpha;
+        }
+        followPV = savedFollowPV;
+        if (searchAborted) return 0.0;
+        pvLength[ply] = ply;  // the exclusion search shares this ply's PV row
+    }
+
+    if (ttMoveLegal && excludedMove == 0) SEARCH_STAT(ttMoveNodes);
+
+    if(isMaximizing){
+        //white to move - maximise eval
+        //initialise max Eval to -infinity (lowest possible eval)
+        double maxEval = -numeric_limits<double>::infinity();
+        double origAlpha = alpha;
+        double origBeta = beta;
+
+    //run through legal moves
+    int moveCount = 0;
+    int movesSearched = 0;  // moveCount also counts pruned moves
+    Move bestLocalMove(-1,-1,-1,-1);
+    vector<Move> quietsTried, capturesTried;
+        for(const Move& move : legalmoves){
+            if (excludedMove != 0 && packMove(move) == excludedMove) continue;
+            // detect capture before making the move (cheap)
+            bool isCapture = false;
+            if (move.moveType == EN_PASSANT) isCapture = true;
+            else if (!isEmpty(board[move.targetRow][move.targetColumn])) isCapture = true;
+            // Checking moves are never reduced; mates are found by the child's own movegen
+            bool givesCheck = moveGivesCheck(move);
+            // Frontier pruning of quiet moves; the first move is always searched
+            if (moveCount > 0 && !isCapture && !givesCheck && move.moveType != PAWN_PROMOTION) {
+                if (futileNode) {
+                    maxEval = max(maxEval, futilityValue);
+                    moveCount++;
+                    continue;
+                }
+                if (lmpNode && moveCount >= LMP_MOVE_COUNT[depth]) {
+                    moveCount++;
+                    continue;
+                }
+            }
+            // LATE MOVE REDUCTIONS (LMR): late quiet moves and losing captures get a shallower search
+            int reduction = 0;
+            if (moveCount >= LMR_FULL_DEPTH_MOVES && depth >= 3 && !inCheck && !givesCheck &&
+                move.moveType != PAWN_PROMOTION && (!isCapture || isLosingCapture(move))) {
+                reduction = lateMoveReduction(depth, moveCount, move, ply, pvNode);
+            }
+            int extension = 0;
+            if (givesCheck && ply < 2 * rootDepth) extension = 1;
+            else if (ttMoveSingular && packMove(move) == ttEntry.packedMove) extension = 1;
+            const int newDepth = depth - 1 + extension;
+            plyPieceTo[ply] = pieceTo(board[move.startRow][move.startColumn], move.targetRow * 8 + move.targetColumn);
+            game.makeMoveForEngine(move);
+            
+            double eval;
+            if (reduction > 0) {
+                // Reduced search; with a finite alpha it only needs to prove eval <= alpha
+                double zwBeta = std::isfinite(alpha) ? alpha + ZERO_WINDOW : beta;
+                SEARCH_STAT(lmrSearches);
+                eval = alphabeta(game, newDepth - reduction, alpha, zwBeta, false, true, ply+1);
+                // Beat alpha: verify at full depth, still with the zero window
+                if (eval > alpha) {
+                    SEARCH_STAT(lmrResearches);
+                    eval = alphabeta(game, newDepth, alpha, zwBeta, false, true, ply+1);
+                    // Holds up inside a wider window: get the exact score
+                    if (eval > alpha && eval < beta && zwBeta < beta) {
+                        eval = alphabeta(game, newDepth, alpha, beta, false, true, ply+1);
+                    }
+                }
+            } else {
+                eval = alphabeta(game, newDepth, alpha, beta, false, true, ply+1);
+            }
+            
+            game.undoMove();
+            if (searchAborted) return 0.0;
+            followPV = false;  // only the first move can be on the previous PV
+            if (eval > maxEval) bestLocalMove = move;
+            if (eval > alpha) updatePV(ply, move);
+            maxEval = max(maxEval, eval);
+            alpha = max(alpha, eval);
+            if (beta <= alpha) {
+                SEARCH_STAT(cutoffs);
+                if (movesSearched == 0) SEARCH_STAT(firstMoveCutoffs);
+                if (ttMoveLegal && packMove(move) == ttEntry.packedMove) SEARCH_STAT(ttMoveCutoffs);
+                updateCutoffStats(move, isCapture, depth, ply, quietsTried, capturesTried);
+                break; // Beta cutoff
+            }
+            if (isCapture) capturesTried.push_back(move);
+            else if (move.moveType != PAWN_PROMOTION) quietsTried.push_back(move);
+            movesSearched++;
+            moveCount++;
+        }
+        
+        // Store in transposition table (if finite) with proper bound
+        if (std::isfinite(maxEval) && excludedMove == 0) {
+            TTBound bound;
+            if (maxEval <= origAlpha) bound = TTBound::UPPER;
+            else if (maxEval >= origBeta) bound = TTBound::LOWER;
+            else bound = TTBound::EXACT;
+            // If this is a mate score, compute mateDistance as plies from THIS position
+            // to mate (D = plyAtMate - plyAtStore). Store it and mark as EXACT to avoid
+            // losing mate info through bound semantics.
+            int mateDist = 0;
+            const double MATE_SCORE = 100000.0;
+            if (std::abs(maxEval) >= (MATE_SCORE - 1000.0)) {
+                int plyAtMate = static_cast<int>(std::round(MATE_SCORE - std::abs(maxEval)));
+                int D = plyAtMate - ply; // plies from this position to mate
+                if (D < 0) D = 0;
+                mateDist = D;
+                // Prefer storing mate entries as EXACT so they are returned precisely later
+                bound = TTBound::EXACT;
+            }
+            uint32_t pm = 0;
+            if (bestLocalMove.startRow != -1) pm = packMove(bestLocalMove);
+            transpositionTable.store(posKey, maxEval, depth, bound, mateDist, pm, storedStaticEval);
+        }
+        return maxEval;
+    } else {
+    //black to move - minimise eval
+    //initialise min Eval to +infinity (highest possible eval)
+    double minEval = numeric_limits<double>::infinity();
+    double origAlpha = alpha;
+    double origBeta = beta;
+
+    //run through legal moves
+    int moveCount = 0;
+    int movesSearched = 0;  // moveCount also counts pruned moves
+    Move bestLocalMove(-1,-1,-1,-1);
+    vector<Move> quietsTried, capturesTried;
+    for(const Move& move : legalmoves){
+            if (excludedMove != 0 && packMove(move) == excludedMove) continue;
+            bool isCapture = (move.moveType == EN_PASSANT) || !isEmpty(board[move.targetRow][move.targetColumn]);
+            bool givesCheck = moveGivesCheck(move);
+            if (moveCount > 0 && !isCapture && !givesCheck && move.moveType != PAWN_PROMOTION) {
+                if (futileNode) {
+                    minEval = min(minEval, futilityValue);
+                    moveCount++;
+                    continue;
+                }
+                if (lmpNode && moveCount >= LMP_MOVE_COUNT[depth]) {
+                    moveCount++;
+                    continue;
+                }
+            }
+            int reduction = 0;
+            if (moveCount >= LMR_FULL_DEPTH_MOVES && depth >= 3 && !inCheck && !givesCheck &&
+                move.moveType != PAWN_PROMOTION && (!isCapture || isLosingCapture(move))) {
+                reduction = lateMoveReduction(depth, moveCount, move, ply, pvNode);
+            }
+            int extension = 0;
+            if (givesCheck && ply < 2 * rootDepth) extension = 1;
+            else if (ttMoveSingular && packMove(move) == ttEntry.packedMove) extension = 1;
+            const int newDepth = depth - 1 + extension;
+            plyPieceTo[ply] = pieceTo(board[move.startRow][move.startColumn], move.targetRow * 8 + move.targetColumn);
+            game.makeMoveForEngine(move);
+            
+            double eval;
+            if (reduction > 0) {
+                // Mirror of the maximizing side: the zero window sits just below beta
+                double zwAlpha = std::isfinite(beta) ? beta - ZERO_WINDOW : alpha;
+                SEARCH_STAT(lmrSearches);
+                eval = alphabeta(game, newDepth - reduction, zwAlpha, beta, true, true, ply+1);
+                if (eval < beta) {
+                    SEARCH_STAT(lmrResearches);
+                    eval = alphabeta(game, newDepth, zwAlpha, beta, true, true, ply+1);
+                    if (eval < beta && eval > alpha && zwAlpha > alpha) {
+                        eval = alphabeta(game, newDepth, alpha, beta, true, true, ply+1);
+                    }
+                }
+            } else {
+                eval = alphabeta(game, newDepth, alpha, beta, true, true, ply+1);
+            }
+            
+            game.undoMove();
+            if (searchAborted) return 0.0;
+            followPV = false;
+            if (eval < minEval) bestLocalMove = move;
+            if (eval < beta) updatePV(ply, move);
+            minEval = min(minEval, eval);
+            beta = min(beta, eval);
+            if (beta <= alpha) {
+                SEARCH_STAT(cutoffs);
+                if (movesSearched == 0) SEARCH_STAT(firstMoveCutoffs);
+                if (ttMoveLegal && packMove(move) == ttEntry.packedMove) SEARCH_STAT(ttMoveCutoffs);
+                updateCutoffStats(move, isCapture, depth, ply, quietsTried, capturesTried);
+                break; // Alpha cutoff
+            }
+            if (isCapture) capturesTried.push_back(move);
+            else if (move.moveType != PAWN_PROMOTION) quietsTried.push_back(move);
+            movesSearched++;
+            moveCount++;
+        }
+        
+        // Store in transposition table (if finite) with proper bound
+        if (std::isfinite(minEval) && excludedMove == 0) {
+            TTBound bound;
+            if (minEval <= origAlpha) bound = TTBound::UPPER;
+            else if (minEval >= origBeta) bound = TTBound::LOWER;
+            else bound = TTBound::EXACT;
+            // If this is a mate score, compute mateDistance from this position to mate
+            int mateDist = 0;
+            const double MATE_SCORE = 100000.0;
+            if (std::abs(minEval) >= (MATE_SCORE - 1000.0)) {
+                int plyAtMate = static_cast<int>(std::round(MATE_SCORE - std::abs(minEval)));
+                int D = plyAtMate - ply; // plies from this position to mate
+                if (D < 0) D = 0;
+                mateDist = D;
+                bound = TTBound::EXACT;
+            }
+            uint32_t pm = 0;
+            if (bestLocalMove.startRow != -1) pm = packMove(bestLocalMove);
+            transpositionTable.store(posKey, minEval, depth, bound, mateDist, pm, storedStaticEval);
+        }
+        return minEval;
+    }
+}
+
+// Set RNG seed used for root move randomization
+template <class Eval>
+void BasicEngine<Eval>::setRngSeed(uint64_t seed) {
+    engineRng.seed((uint32_t)seed);
+}
+
+// Profiling accessors (the counters are shared by all engine instantiations)
+template <class Eval>
+long long BasicEngine<Eval>::getTTLookupTime() { return ttLookupTime; }
+template <class Eval>
+long long BasicEngine<Eval>::getEvalTime() { return evalTime; }
+template <class Eval>
+long long BasicEngine<Eval>::getMoveGenTime() { return moveGenTime; }
+template <class Eval>
+int BasicEngine<Eval>::getTTLookupCalls() { return ttLookupCalls; }
+template <class Eval>
+int BasicEngine<Eval>::getEvalCalls() { return evalCalls; }
+template <class Eval>
+int BasicEngine<Eval>::getMoveGenCalls() { return moveGenCalls; }
+// Make/undo helpers
+template <class Eval>
+void BasicEngine<Eval>::addMakeMoveTime(long long us) { makeMoveTime += us; makeMoveCalls++; }
+template <class Eval>
+void BasicEngine<Eval>::addUndoMoveTime(long long us) { undoMoveTime += us; undoMoveCalls++; }
+template <class Eval>
+long long BasicEngine<Eval>::getMakeMoveTime() { return makeMoveTime; }
+template <class Eval>
+long long BasicEngine<Eval>::getUndoMoveTime() { return undoMoveTime; }
+template <class Eval>
+int BasicEngine<Eval>::getMakeMoveCalls() { return makeMoveCalls; }
+template <class Eval>
+int BasicEngine<Eval>::getUndoMoveCalls() { return undoMoveCalls; }
+
+// Root-specific ordering: checking moves go above MVV-LVA captures so the
+// search doesn't overlook forced mates.
+template <class Eval>
+void BasicEngine<Eval>::orderRootMoves(ChessGame& game, vector<Move>& moves) {
+    (void)game;
+    struct MoveScore { Move move; int score; };
+    vector<MoveScore> scored;
+
+    for (const Move& move : moves) {
+        int score = 0;
+
+        // Checks first: forcing lines (and any mate-in-one) get searched early
+        if (moveGivesCheck(move)) {
+            score += 20000;
+        }
+        // Keep MVV-LVA capture scoring as a tiebreaker
+        int capturedPiece = EMPTY;
+        if (move.moveType == EN_PASSANT) {
+            capturedPiece = board[move.startRow][move.targetColumn];
+        } else {
+            capturedPiece = board[move.targetRow][move.targetColumn];
+        }
+        int movingPiece = board[move.startRow][move.startColumn];
+        if (!isEmpty(capturedPiece)) {
+            int victimValue = 0;
+            int attackerValue = 0;
+            int victimType = capturedPiece & 0b0111;
+            int attackerType = movingPiece & 0b0111;
+            switch(victimType) {
+                case 0b0001: victimValue = 1; break;
+                case 0b0011: victimValue = 3; break;
+                case 0b0100: victimValue = 3; break;
+                case 0b0010: victimValue = 5; break;
+                case 0b0101: victimValue = 9; break;
+                default: victimValue = 0; break;
+            }
+            switch(attackerType) {
+                case 0b0001: attackerValue = 1; break;
+                case 0b0011: attackerValue = 3; break;
+                case 0b0100: attackerValue = 3; break;
+                case 0b0010: attackerValue = 5; break;
+                case 0b0101: attackerValue = 9; break;
+                case 0b0110: attackerValue = 10; break;
+                default: attackerValue = 0; break;
+            }
+            score += 1000 + (victimValue * 10) - attackerValue;
+        }
+
+        // Promotions are also valuable
+        if (move.moveType == PAWN_PROMOTION) score += 900;
+
+        scored.push_back({move, score});
+    }
+
+    sort(scored.begin(), scored.end(), [](const MoveScore& a, const MoveScore& b) {
+        return a.score > b.score;
+    });
+
+    moves.clear();
+    for (const auto& ms : scored) moves.push_back(ms.move);
+}
+
+template <class Eval>
+double BasicEngine<Eval>::evaluateCached(ChessGame& game) {
+    uint64_t key = game.getZobristHash();
+    double eval;
+    if (evalHash.probe(key, eval)) return eval;
+    auto evalStart = std::chrono::high_resolution_clock::now();
+    eval = evaluator.evaluate(game);
+    auto evalEnd = std::chrono::high_resolution_clock::now();
+    evalTime += std::chrono::duration_cast<std::chrono::microseconds>(evalEnd - evalStart).count();
+    evalCalls++;
+    evalHash.store(key, eval);
+    return eval;
+}
+
+template <class Eval>
+double BasicEngine<Eval>::evaluateCached(ChessGame& game, double alpha, double beta) {
+    if constexpr (!HasWindowedEvaluate<Eval>::value) {
+        (void)alpha;
+        (void)beta;
+        return evaluateCached(game);
+    } else {
+        uint64_t key = game.getZobristHash();
+        double eval;
+        if (evalHash.probe(key, eval)) return eval;
+        auto evalStart = std::chrono::high_resolution_clock::now();
+        eval = evaluator.evaluate(game, alpha, beta);
+        auto evalEnd = std::chrono::high_resolution_clock::now();
+        evalTime += std::chrono::duration_cast<std::chrono::microseconds>(evalEnd - evalStart).count();
+        evalCalls++;
+        // Outside the window the result may be a lazy bound rather than the score
+        if (eval > alpha && eval < beta) evalHash.store(key, eval);
+        else evalsOutsideWindow++;
+        return eval;
+    }
+}
+
+// Order moves during search: winning/equal captures (MVV-LVA, then capture
+// history), promotions, killers, the counter move, quiet moves by butterfly +
+// continuation history, and losing captures (SEE < 0) last.
+template <class Eval>
+void BasicEngine<Eval>::orderMovesForSearch(ChessGame& game, vector<Move>& moves, int ply) {
+    (void)game;
+    if (moves.size() <= 1) return;
+    const int GOOD_CAPTURE = 2000000;
+    const int PROMOTION = 1900000;
+    const int KILLER_1 = 1000000;
+    const int KILLER_2 = 800000;
+    const int COUNTER_MOVE = 600000;  // quiet history stays within +-3*HISTORY_MAX below this
+    const int BAD_CAPTURE = -1000000;
+
+    std::vector<std::pair<int, Move>> scored;
+    scored.reserve(moves.size());
+    uint32_t k0 = killers[ply][0];
+    uint32_t k1 = killers[ply][1];
+    uint32_t counter = (ply >= 1 && plyPieceTo[ply - 1] >= 0) ? counterMoves[plyPieceTo[ply - 1]] : 0;
+    for (const Move &m : moves) {
+        int score = 0;
+        int victim = capturedPieceOf(m);
+        if (!isEmpty(victim)) {
+            // One MVV-LVA step (a pawn of victim value) outweighs most capture history
+            int mvvLva = static_cast<int>(seePieceValue(victim) * 10 - seePieceValue(board[m.startRow][m.startColumn]));
+            score = (isLosingCapture(m) ? BAD_CAPTURE : GOOD_CAPTURE) + mvvLva * 100 + captureHistoryScore(m) / 16;
+        } else if (m.moveType == PAWN_PROMOTION) {
+            score = PROMOTION + static_cast<int>(seePieceValue(m.promotionPiece));
+        } else {
+            uint32_t pm = packMove(m);
+            if (pm == k0) score = KILLER_1;
+            else if (pm == k1) score = KILLER_2;
+            else if (pm == counter) score = COUNTER_MOVE;
+            else score = quietHistory(m, ply);
+        }
+        scored.emplace_back(score, m);
+    }
+    stable_sort(scored.begin(), scored.end(), [](const auto &a, const auto &b){ return a.first > b.first; });
+    // write back
+    for (size_t i = 0; i < scored.size(); ++i) moves[i] = scored[i].second;
+}
+
+// History gravity: large bonuses saturate towards +-HISTORY_MAX instead of
+// growing without bound, and a malus pulls an entry back down.
+inline void applyHistoryBonus(int &entry, int bonus, int historyMax) {
+    entry += bonus - entry * std::abs(bonus) / historyMax;
+}
+
+inline void applyHistoryBonus(int16_t &entry, int bonus, int historyMax) {
+    int value = entry;
+    applyHistoryBonus(value, bonus, historyMax);
+    entry = static_cast<int16_t>(value);
+}
+
+template <class Eval>
+int BasicEngine<Eval>::quietHistory(const Move& move, int ply) const {
+    int to = move.targetRow * 8 + move.targetColumn;
+    int score = history[(move.startRow * 8 + move.startColumn) * 64 + to];
+    int current = pieceTo(board[move.startRow][move.startColumn], to);
+    for (int back = 1; back <= 2 && ply - back >= 0; ++back) {
+        int previous = plyPieceTo[ply - back];
+        if (previous >= 0) score += continuationHistory[previous * PIECE_TO_SIZE + current];
+    }
+    return score;
+}
+
+template <class Eval>
+int BasicEngine<Eval>::captureHistoryScore(const Move& move) const {
+    int attacker = pieceTo(board[move.startRow][move.startColumn], move.targetRow * 8 + move.targetColumn);
+    return captureHistory[attacker * 8 + (capturedPieceOf(move) & 0b0111)];
+}
+
+// Called after the cutoff move has been undone, so the board is this node's position
+template <class Eval>
+void BasicEngine<Eval>::updateCutoffStats(const Move& best, bool bestIsCapture, int depth, int ply,
+                               const vector<Move>& quietsTried, const vector<Move>& capturesTried) {
+    const int bonus = std::min(64 * depth * depth, HISTORY_MAX / 4);
+
+    auto updateQuiet = [&](const Move& m, int delta) {
+        int to = m.targetRow * 8 + m.targetColumn;
+        applyHistoryBonus(history[(m.startRow * 8 + m.startColumn) * 64 + to], delta, HISTORY_MAX);
+        int current = pieceTo(board[m.startRow][m.startColumn], to);
+        for (int back = 1; back <= 2 && ply - back >= 0; ++back) {
+            int previous = plyPieceTo[ply - back];
+            if (previous >= 0) {
+                applyHistoryBonus(continuationHistory[previous * PIECE_TO_SIZE + current], delta, HISTORY_MAX);
+            }
+        }
+    };
+    auto updateCapture = [&](const Move& m, int delta) {
+        int attacker = pieceTo(board[m.startRow][m.startColumn], m.targetRow * 8 + m.targetColumn);
+        applyHistoryBonus(captureHistory[attacker * 8 + (capturedPieceOf(m) & 0b0111)], delta, HISTORY_MAX);
+    };
+
+    if (bestIsCapture) {
+        updateCapture(best, bonus);
+    } else if (best.moveType != PAWN_PROMOTION) {
+        uint32_t pm = packMove(best);
+        if (killers[ply][0] != pm) {
+            killers[ply][1] = killers[ply][0];
+            killers[ply][0] = pm;
+        }
+        if (ply >= 1 && plyPieceTo[ply - 1] >= 0) counterMoves[plyPieceTo[ply - 1]] = pm;
+        updateQuiet(best, bonus);
+        // Quiets searched before the cutoff move failed to cut: malus
+        for (const Move& m : quietsTried) updateQuiet(m, -bonus);
+    }
+    for (const Move& m : capturesTried) updateCapture(m, -bonus);
+}
+
+// Checks-only proof search: can the attacker force mate within depthLeft plies?
+// OR over the attacker's checking moves, AND over all defender replies.
+template <class Eval>
+bool BasicEngine<Eval>::mateSearch(ChessGame& game, int depthLeft, bool attackerIsWhite) {
+    proverNodes++;
+    if (checkLimits() || proverNodes > MATE_SEARCH_NODE_BUDGET) {
+        mateSearchAborted = true;
+        return false;
+    }
+
+    // The same position can be a win for one side and not the other
+    uint64_t key = game.getZobristHash() ^ (attackerIsWhite ? 0x9E3779B97F4A7C15ULL : 0ULL);
+    MateCacheEntry &entry = mateCache[key & (mateCache.size() - 1)];
+    if (entry.key == key) {
+        if (entry.proven > 0 && entry.proven <= depthLeft) return true;
+        if (entry.disproven >= depthLeft) return false;
+    } else {
+        entry = MateCacheEntry();
+        entry.key = key;
+    }
+    auto finish = [&](bool mate) {
+        // The slot may have been taken over by a child position meanwhile
+        if (entry.key != key) {
+            entry = MateCacheEntry();
+            entry.key = key;
+        }
+        if (mate) {
+            if (entry.proven == 0 || depthLeft < entry.proven) entry.proven = static_cast<int8_t>(depthLeft);
+        } else if (depthLeft > entry.disproven) {
+            entry.disproven = static_cast<int8_t>(depthLeft);
+        }
+        return mate;
+    };
+
+    bool sideToMoveIsAttacker = (game.isWhiteToMove() == attackerIsWhite);
+    vector<Move> legal = game.getLegalMoves();
+    if (legal.empty()) {
+        // Only a checkmated defender counts; stalemate or a mated attacker is a failure
+        return finish(!sideToMoveIsAttacker && game.isInCheck());
+    }
+
+    if (sideToMoveIsAttacker) {
+        if (depthLeft < 1) return finish(false);
+        for (const Move& mv : legal) {
+            if (!moveGivesCheck(mv)) continue;
+            game.makeMoveForEngine(mv);
+            bool res = mateSearch(game, depthLeft - 1, attackerIsWhite);
+            game.undoMove();
+            if (mateSearchAborted) return false;
+            if (res) return finish(true);
+        }
+        return finish(false);
+    } else {
+        // Defender to move and not mated: the attacker still needs at least one more move
+        if (depthLeft < 2) return finish(false);
+        for (const Move& mv : legal) {
+            game.makeMoveForEngine(mv);
+            bool res = mateSearch(game, depthLeft - 1, attackerIsWhite);
+            game.undoMove();
+            if (mateSearchAborted) return false;
+            if (!res) return finish(false); // defender found a way to avoid mate
+        }
+        return finish(true); // all replies lead to mate
+    }
+}
+
+template <class Eval>
+bool BasicEngine<Eval>::rootMateProver(ChessGame& game, int maxDepth, Move& outMove, int& outPlies) {
+    bool attackerIsWhite = game.isWhiteToMove();
+    vector<Move> legal = game.getLegalMoves();
+    if (legal.empty()) return false;
+    if (mateCache.empty()) mateCache.resize(1 << 16);
+    mateSearchAborted = false;
+
+    // Mates are delivered on the attacker's move: try 1, 3, 5, ... plies
+    for (int d = 1; d <= maxDepth; d += 2) {
+        for (const Move& mv : legal) {
+            if (!moveGivesCheck(mv)) continue;
+            game.makeMoveForEngine(mv);
+            bool forces = mateSearch(game, d - 1, attackerIsWhite);
+            game.undoMove();
+            if (mateSearchAborted) return false;
+            if (forces) {
+                outMove = mv;
+                outPlies = d;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <class Eval>
+int BasicEngine<Eval>::lateMoveReduction(int depth, int moveIndex, const Move& move, int ply, bool pvNode) const {
+    int r = lmrTable[std::min(depth, LMR_TABLE_SIZE - 1)][std::min(moveIndex, LMR_TABLE_SIZE - 1)];
+    if (!pvNode) r++;
+    uint32_t pm = packMove(move);
+    if (pm == killers[ply][0] || pm == killers[ply][1]) r--;
+    r -= std::clamp(quietHistory(move, ply) / 8192, -2, 2);
+    // Never drop straight into quiescence from a reduction
+    return std::clamp(r, 0, depth - 2);
+}
+
+// Record 'move' as best at 'ply', followed by the child's line
+template <class Eval>
+void BasicEngine<Eval>::updatePV(int ply, const Move& move) {
+    pvTable[ply][ply] = packMove(move);
+    int next = (ply + 1 < MAX_PLY) ? pvLength[ply + 1] : ply + 1;
+    for (int j = ply + 1; j < next; ++j) pvTable[ply][j] = pvTable[ply + 1][j];
+    pvLength[ply] = next;
+}
+
+// Copy the PV of the last completed iteration (prevPV) into lastResult. Lines cut
+// short by TT hits are extended by following TT moves up to 'depth' plies.
+template <class Eval>
+void BasicEngine<Eval>::fillResultPV(ChessGame& game, int depth) {
+    lastResult.pv.clear();
+    if (prevPV.empty() || prevPV[0] != packMove(lastResult.bestMove)) {
+        lastResult.pv.push_back(lastResult.bestMove);
+    } else {
+        for (uint32_t pm : prevPV) lastResult.pv.push_back(unpackMove(pm));
+    }
+    int made = 0;
+    for (const Move& m : lastResult.pv) {
+        game.makeMoveForEngine(m);
+        made++;
+    }
+    collectPV(game, depth - made, lastResult.pv);
+    for (int i = 0; i < made; ++i) game.undoMove();
+}
+
+// Walk the TT best moves from the current position. Every move is checked
+// against the legal move list since a TT entry may belong to a colliding key.
+template <class Eval>
+void BasicEngine<Eval>::collectPV(ChessGame& game, int maxLength, std::vector<Move>& pv) {
+    int made = 0;
+    while (made < maxLength) {
+        TTEntry entry;
+        if (!transpositionTable.probe(game.getZobristHash(), entry) || entry.packedMove == 0) break;
+        Move ttMove = unpackMove(entry.packedMove);
+        vector<Move> legal = game.getLegalMoves();
+        auto it = find_if(legal.begin(), legal.end(), [&ttMove](const Move& m) {
+            return m.startRow == ttMove.startRow && m.startColumn == ttMove.startColumn &&
+                   m.targetRow == ttMove.targetRow && m.targetColumn == ttMove.targetColumn &&
+                   m.promotionPiece == ttMove.promotionPiece;
+        });
+        if (it == legal.end()) break;
+        pv.push_back(*it);
+        game.makeMoveForEngine(*it);
+        made++;
+    }
+    for (int i = 0; i < made; ++i) game.undoMove();
+}
+
+// Diagnostics: forward TT summary
+template <class Eval>
+void BasicEngine<Eval>::printTTSummary() const {
+    transpositionTable.printSummary();
+    cout << "  static evals from TT entries: " << ttStaticEvalHits << "\n";
+    cout << "EvalHash: probes: " << evalHash.probeCount << ", hits: " << evalHash.hitCount << ", hit%: ";
+    if (evalHash.probeCount) cout << (100.0 * evalHash.hitCount / evalHash.probeCount) << "%\n"; else cout << "0%\n";
+    cout << "  quiescence evals outside the window (not cached): " << evalsOutsideWindow << "\n";
+}
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include "evalParams.hpp"
+#include <fstream>
+#include <sstream>
+
+//using PST's from: https://www.chessprogramming.org/PeSTO%27s_Evaluation_Function
+// Piece-Square Tables (PST) - bonuses for pieces on good squares
+// Values are from white's perspective (flip for black)
+// Values in centipawns (1 pawn = 100), will be scaled to match material values
+static const int pawnPST[8][8] = {
+    {  0,  0,  0,  0,  0,  0,  0,  0},  // Rank 8 (pawns can't be here)
+    { 98, 134, 61, 95, 68, 126, 34, -11},  // Rank 7 (about to promote!)
+    {-6,   7,  26,  31,  65,  56, 25, -20},  // Rank 6
+    {-14,  13,  6,  21,  23,  12, 17, -23},  // Rank 5
+    {-27,  -2,  -5,  12,  17,   6, 10, -25},  // Rank 4 (center pawns)
+    {-26,  -4,  -4, -10,   3,   3, 33, -12},  // Rank 3
+    {-35,  -1, -20, -23, -15,  24, 38, -22},  // Rank 2 (penalize d/e pawns not moved)
+    {  0,  0,  0,  0,  0,  0,  0,  0}   // Rank 1 (pawns can't be here)
+};
+
+static const int knightPST[8][8] = {
+    {-167, -89, -34, -49,  61, -97, -15, -107},  // Knights on rim are dim
+    {-73, -41,  72,  36,  23,  62,   7,  -17},
+    {-47,  60,  37,  65,  84, 129,  73,   44},
+    {-9,  17,  19,  53,  37,  69,  18,   22},  // Knights love the center
+    {-13,   4,  16,  13,  28,  19,  21,   -8},
+    {-23,  -9,  12,  10,  19,  17,  25,  -16},
+    {-29, -53, -12,  -3,  -1,  18, -14,  -19},
+    {-105, -21, -58, -33, -17, -28, -19,  -23}
+};
+
+static const int bishopPST[8][8] = {
+    {-30,  10, -90, -40, -30, -50,  10, -10},
+    {-30,  30, -10, -10,  50,  80,  30, -50},  // Developed bishops - increased bonus
+    {-20,  60,  60,  60,  55,  70,  60,  10},  // Good diagonals - increased bonus
+    {-5,  20,  35,  70,  60,  60,  20,  10},  // Active bishops - increased bonus
+    {-10,  25,  25,  45,  50,  30,  25,  15},
+    {0,  30,  30,  30,  30,  45,  35,  20},
+    {5,  30,  30,  5,  15,  40,  50,  10},
+    {-40,  -10, -20, -30, -20, -20, -50, -30}  // Starting position - increased penalty
+};
+
+static const int rookPST[8][8] = {
+    {32,  42,  32,  51, 63,  9,  31,  43},
+    {27,  32,  58,  62, 80, 67,  26,  44},
+    {27,  32,  58,  62, 80, 67,  26,  44},
+    {-24, -11,   7,  26, 24, 35,  -8, -20},
+    {-36, -26, -12,  -1,  9, -7,   6, -23},
+    {-45, -25, -16, -17,  3,  0,  -5, -33},
+    {-44, -16, -20,  -9, -1, 11,  -6, -71},
+    {-19, -13,   1,  17, 16,  7, -37, -26}
+};
+
+static const int queenPST[8][8] = {
+    {-28,   0,  29,  12,  59,  44,  43,  45},
+    {-24, -39,  -5,   1, -16,  57,  28,  54},
+    {-13, -17,   7,   8,  29,  56,  47,  57},
+    {-27, -27, -16, -16,  -1,  17,  -2,   1},
+    {-9, -26,  -9, -10,  -2,  -4,   3,  -3},
+    {-14,   2, -11,  -2,  -5,   2,  14,   5},
+    {-35,  -8,  11,   2,   8,  15,  -3,   1},
+    {-1, -18,  -9,  10, -15, -25, -31, -50}
+};
+
+static const int kingMiddlegamePST[8][8] = {
+    {-65,  23,  16, -15, -56, -34,   2,  13},
+    {29,  -1, -20,  -7,  -8,  -4, -38, -29},
+    {-9,  24,   2, -16, -20,   6,  22, -22},
+    {-17, -20, -12, -27, -30, -25, -14, -36},
+    {-49,  -1, -27, -39, -46, -44, -33, -51},
+    {-14, -14, -22, -46, -44, -30, -15, -27},
+    {1,   7,  -8, -64, -43, -16,   9,   8},
+    {-15,  36,  12, -54,   8, -28,  24,  14}
+};
+
+// Endgame tables (PeSTO), same layout as the middlegame tables above
+static const int pawnEndgamePST[8][8] = {
+    {  0,   0,   0,   0,   0,   0,   0,   0},
+    {178, 173, 158, 134, 147, 132, 165, 187},
+    { 94, 100,  85,  67,  56,  53,  82,  84},
+    { 32,  24,  13,   5,  -2,   4,  17,  17},
+    { 13,   9,  -3,  -7,  -7,  -8,   3,  -1},
+    {  4,   7,  -6,   1,   0,  -5,  -1,  -8},
+    { 13,   8,   8,  10,  13,   0,   2,  -7},
+    {  0,   0,   0,   0,   0,   0,   0,   0}
+};
+
+static const int knightEndgamePST[8][8] = {
+    {-58, -38, -13, -28, -31, -27, -63, -99},
+    {-25,  -8, -25,  -2,  -9, -25, -24, -52},
+    {-24, -20,  10,   9,  -1,  -9, -19, -41},
+    {-17,   3,  22,  22,  22,  11,   8, -18},
+    {-18,  -6,  16,  25,  16,  17,   4, -18},
+    {-23,  -3,  -1,  15,  10,  -3, -20, -22},
+    {-42, -20, -10,  -5,  -2, -20, -23, -44},
+    {-29, -51, -23, -15, -22, -18, -50, -64}
+};
+
+static const int bishopEndgamePST[8][8] = {
+    {-14, -21, -11,  -8,  -7,  -9, -17, -24},
+    { -8,  -4,   7, -12,  -3, -13,  -4, -14},
+    {  2,  -8,   0,  -1,  -2,   6,   0,   4},
+    { -3,   9,  12,   9,  14,  10,   3,   2},
+    { -6,   3,  13,  19,   7,  10,  -3,  -9},
+    {-12,  -3,   8,  10,  13,   3,  -7, -15},
+    {-14, -18,  -7,  -1,   4,  -9, -15, -27},
+    {-23,  -9, -23,  -5,  -9, -16,  -5, -17}
+};
+
+static const int rookEndgamePST[8][8] = {
+    { 13,  10,  18,  15,  12,  12,   8,   5},
+    { 11,  13,  13,  11,  -3,   3,   8,   3},
+    {  7,   7,   7,   5,   4,  -3,  -5,  -3},
+    {  4,   3,  13,   1,   2,   1,  -1,   2},
+    {  3,   5,   8,   4,  -5,  -6,  -8, -11},
+    { -4,   0,  -5,  -1,  -7, -12,  -8, -16},
+    { -6,  -6,   0,   2,  -9,  -9, -11,  -3},
+    { -9,   2,   3,  -1,  -5, -13,   4, -20}
+};
+
+static const int queenEndgamePST[8][8] = {
+    { -9,  22,  22,  27,  27,  19,  10,  20},
+    {-17,  20,  32,  41,  58,  25,  30,   0},
+    {-20,   6,   9,  49,  47,  35,  19,   9},
+    {  3,  22,  24,  45,  57,  40,  57,  36},
+    {-18,  28,  19,  47,  31,  34,  39,  23},
+    {-16, -27,  15,   6,   9,  17,  10,   5},
+    {-22, -23, -30, -16, -16, -23, -36, -32},
+    {-33, -28, -22, -43,  -5, -32, -20, -41}
+};
+
+static const int kingEndgamePST[8][8] = {
+    {-74, -35, -18, -18, -11,  15,   4, -17},
+    {-12,  17,  14,  17,  17,  38,  23,  11},
+    { 10,  17,  23,  15,  20,  45,  44,  13},
+    { -8,  22,  24,  27,  26,  33,  26,   3},
+    {-18,  -4,  21,  24,  27,  23,   9, -11},
+    {-19,  -3,  11,  21,  23,  16,   7,  -9},
+    {-27, -11,   4,  13,  14,   4,  -5, -17},
+    {-53, -34, -21, -11, -28, -14, -24, -43}
+};
+
+static EvalParams buildDefaultParams() {
+    EvalParams p{};
+    const int material[7] = {0, 100, 500, 300, 300, 900, 0};
+    const int (*mg[7])[8] = {nullptr, pawnPST, rookPST, knightPST, bishopPST, queenPST, kingMiddlegamePST};
+    const int (*eg[7])[8] = {nullptr, pawnEndgamePST, rookEndgamePST, knightEndgamePST, bishopEndgamePST, queenEndgamePST, kingEndgamePST};
+    for (int type = 1; type < 7; type++) {
+        p.material[type] = material[type];
+        for (int sq = 0; sq < 64; sq++) {
+            p.pstMg[type][sq] = mg[type][sq / 8][sq % 8];
+            p.pstEg[type][sq] = eg[type][sq / 8][sq % 8];
+        }
+    }
+
+    // Attack-map terms
+    const int mobilityWeight[7]   = {0, 0, 2, 4, 4, 1, 0};
+    const int mobilityBaseline[7] = {0, 0, 7, 4, 6, 13, 0};
+    const int kingAttackUnits[7]  = {0, 0, 3, 2, 2, 5, 0};
+    for (int type = 0; type < 7; type++) {
+        p.mobilityWeight[type] = mobilityWeight[type];
+        p.mobilityBaseline[type] = mobilityBaseline[type];
+        p.kingAttackUnits[type] = kingAttackUnits[type];
+    }
+    p.kingAttackMax = 300;
+    p.hangingPawn = 10;
+    p.hangingPiece = 30;
+    p.threatByPawn = 50;
+    p.threatByMinor = 40;
+    p.threatByRook = 30;
+    return p;
+}
+
+const EvalParams& defaultEvalParams() {
+    static const EvalParams params = buildDefaultParams();
+    return params;
+}
+
+bool loadEvalParams(const std::string& path, EvalParams& params) {
+    std::ifstream in(path);
+    if (!in) return false;
+    // Strip comments
+    std::string text, line;
+    while (std::getline(in, line)) text += line.substr(0, line.find('#')) + "\n";
+
+    EvalParams loaded = params;
+    std::istringstream tokens(text);
+    std::string name;
+    while (tokens >> name) {
+        bool found = false, complete = true;
+        forEachParam(loaded, [&](const char* groupName, int* values, int count, bool) {
+            if (found || name != groupName) return;
+            found = true;
+            for (int i = 0; i < count; i++) complete &= static_cast<bool>(tokens >> values[i]);
+        });
+        if (!found || !complete) return false;
+    }
+    params = loaded;
+    return true;
+}
+
+bool saveEvalParams(const std::string& path, const EvalParams& params) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "# Evaluation parameters (centipawns), see evalParams.hpp\n";
+    EvalParams p = params;
+    forEachParam(p, [&](const char* name, int* values, int count, bool) {
+        out << name;
+        // Long groups (PSTs) one board row per line
+        for (int i = 0; i < count; i++) out << ((count > 8 && i % 8 == 0) ? "\n   " : " ") << values[i];
+        out << "\n";
+    });
+    return static_cast<bool>(out);
+}
+
+#ifndef EVAL_FROZEN_PARAMS
+// Active parameters plus the packed PSTs derived from them
+struct ActiveEvalParams {
+    EvalParams params;
+    PackedPstTable packed;
+
+    void set(const EvalParams& p) {
+        params = p;
+        packed = packPst(p);
+    }
+};
+
+static ActiveEvalParams& active() {
+    static ActiveEvalParams a = [] {
+        ActiveEvalParams init;
+        init.set(defaultEvalParams());
+        return init;
+    }();
+    return a;
+}
+
+const EvalParams& evalParams() { return active().params; }
+
+void setEvalParams(const EvalParams& params) { active().set(params); }
+
+const Score* packedPst(int pieceType) { return active().packed.values[pieceType]; }
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+#include "score.hpp"
+#include <string>
+
+// Tunable evaluation parameters, all in centipawns. Arrays indexed by piece
+// type use the board's codes (1 pawn, 2 rook, 3 knight, 4 bishop, 5 queen,
+// 6 king); PSTs are [piece type][row * 8 + col] from white's point of view
+// (row 0 = rank 8), mirrored for black.
+struct EvalParams {
+    int material[7];
+    int pstMg[7][64];
+    int pstEg[7][64];
+    int mobilityWeight[7];    // per safe square attacked
+    int mobilityBaseline[7];  // squares of an "average" piece (not tuned)
+    int kingAttackUnits[7];   // per attacked king-zone square
+    int kingAttackMax;
+    int hangingPawn;
+    int hangingPiece;
+    int threatByPawn;         // piece attacked by an enemy pawn
+    int threatByMinor;        // rook or queen attacked by a knight or bishop
+    int threatByRook;         // queen attacked by a rook
+};
+
+// Visit every parameter group as (name, values, count, tunable). Tuners and
+// parameter files use this order and these names.
+template <class Params, class F>
+void forEachParam(Params& p, F&& f) {
+    f("material", &p.material[0], 7, true);
+    f("pst_mg", &p.pstMg[0][0], 7 * 64, true);
+    f("pst_eg", &p.pstEg[0][0], 7 * 64, true);
+    f("mobility_weight", &p.mobilityWeight[0], 7, true);
+    f("mobility_baseline", &p.mobilityBaseline[0], 7, false);
+    f("king_attack_units", &p.kingAttackUnits[0], 7, true);
+    f("king_attack_max", &p.kingAttackMax, 1, true);
+    f("hanging_pawn", &p.hangingPawn, 1, true);
+    f("hanging_piece", &p.hangingPiece, 1, true);
+    f("threat_by_pawn", &p.threatByPawn, 1, true);
+    f("threat_by_minor", &p.threatByMinor, 1, true);
+    f("threat_by_rook", &p.threatByRook, 1, true);
+}
+
+// The hand-written values the engine ships with
+const EvalParams& defaultEvalParams();
+
+// Parameter files are text: a group name from forEachParam followed by its
+// values, whitespace separated; '#' starts a comment. Groups not in the file
+// keep the values 'params' already has. load fails on unknown names, short
+// groups or unreadable files, leaving 'params' untouched.
+bool loadEvalParams(const std::string& path, EvalParams& params);
+bool saveEvalParams(const std::string& path, const EvalParams& params);
+
+// PSTs with mg/eg packed into one Score, [piece type][square]
+struct PackedPstTable {
+    Score values[7][64];
+};
+
+constexpr PackedPstTable packPst(const EvalParams& p) {
+    PackedPstTable t{};
+    for (int type = 0; type < 7; type++) {
+        for (int sq = 0; sq < 64; sq++) t.values[type][sq] = makeScore(p.pstMg[type][sq], p.pstEg[type][sq]);
+    }
+    return t;
+}
+
+#ifdef EVAL_FROZEN_PARAMS
+// Frozen build (CMake EVAL_FROZEN_PARAMS): the parameters are compile-time
+// constants generated from EVAL_PARAMS_FILE, so the evaluation folds them
+// like the literal tables it used to have. setEvalParams is not available.
+inline constexpr EvalParams FROZEN_EVAL_PARAMS = {
+#include "evalParamsFrozen.inc"
+};
+inline constexpr PackedPstTable FROZEN_PACKED_PST = packPst(FROZEN_EVAL_PARAMS);
+
+inline const EvalParams& evalParams() { return FROZEN_EVAL_PARAMS; }
+inline const Score* packedPst(int pieceType) { return FROZEN_PACKED_PST.values[pieceType]; }
+#else
+// Parameters used by Evaluation; starts as defaultEvalParams(). Not
+// synchronised: set them before any search or batch evaluation starts.
+const EvalParams& evalParams();
+void setEvalParams(const EvalParams& params);
+
+// evalParams() PSTs packed, [piece type][square]
+const Score* packedPst(int pieceType);
+#endif
+
+// Game phase weight per piece type (knight/bishop 1, rook 2, queen 4)
+constexpr int PHASE_WEIGHT[7] = {0, 0, 2, 1, 1, 4, 0};
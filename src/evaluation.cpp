@@ -1,16 +1,25 @@
 #include "evaluation.hpp"
 #include "game.hpp"
+#include "score.hpp"
+#include "evalParams.hpp"
+#include "endgame.hpp"
 
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <array>
+#include <thread>
 using namespace std;
 
 //using PST's from: https://www.chessprogramming.org/PeSTO%27s_Evaluation_Function
-// for now only middle game tables
+// middlegame and endgame tables (evalParams.cpp), tapered by game phase (see position())
 // Main evaluation function
 double Evaluation::evaluate(const ChessGame& game) const {
+    // Known endings: an exact score, or a scale factor for the general one
+    const EndgameEntry* ending = findEndgame(game.getMaterialKey());
+    if (ending && ending->evaluate) return ending->value(board, game.isWhiteToMove());
+
     double evaluation = 0.0;
 
     double mat = materialCount(game);
@@ -19,10 +28,14 @@ double Evaluation::evaluate(const ChessGame& game) const {
     double pawn = 0.01*pawnStructure(game); // Was 3.32665, too high
     // Removed mating patterns and king tropism - material should dominate
     
-    // Mobility bonus removed - too expensive to calculate getLegalMoves() on every eval
-    // TODO: Add back more intelligently (only at root/PV nodes, or cache the count)
+    // Mobility, king-zone attacks and threats from one bitboard attack pass
+    // (replaces the old getLegalMoves() mobility term)
+    AttackMaps maps;
+    computeAttackMaps(board, maps);
+    double act = activity(maps);
     
-    evaluation = mat + pos + king + pawn;
+    evaluation = mat + act + pos + king + pawn;  // same order as the lazy overload
+    if (ending) evaluation *= ending->scale(board, ending->strong);
     
     // Debug output - ENABLED for debugging queen capture issue
     // cout << "Eval - Mat: " << mat << " Pos: " << pos 
@@ -31,9 +44,31 @@ double Evaluation::evaluate(const ChessGame& game) const {
     return evaluation;
 }
 
+// Same sum as evaluate(), cheapest terms first, stopping once the rest can't
+// bring the score back into (alpha, beta)
+double Evaluation::evaluate(const ChessGame& game, double alpha, double beta) const {
+    // The margins don't hold for endgame scores and scaling; those are rare
+    if (findEndgame(game.getMaterialKey())) return evaluate(game);
+
+    double evaluation = materialCount(game);
+    double margin = LAZY_ACTIVITY_MARGIN + LAZY_POSITIONAL_MARGIN;
+    if (evaluation + margin <= alpha) return evaluation + margin;
+    if (evaluation - margin >= beta) return evaluation - margin;
+
+    AttackMaps maps;
+    computeAttackMaps(board, maps);
+    evaluation += activity(maps);
+    margin = LAZY_POSITIONAL_MARGIN;
+    if (evaluation + margin <= alpha) return evaluation + margin;
+    if (evaluation - margin >= beta) return evaluation - margin;
+
+    return evaluation + 0.01*position(game) + 0.01*kingsafety(game) + 0.01*pawnStructure(game);
+}
+
 // Count material value - optimized to use board directly instead of FEN
 double Evaluation::materialCount(const ChessGame& game) const {
     double count = 0;
+    const int* material = evalParams().material;
     
     // Iterate through the board array directly (much faster than parsing FEN)
     for (int row = 0; row < 8; row++) {
@@ -43,18 +78,10 @@ double Evaluation::materialCount(const ChessGame& game) const {
             
             // Get piece type (bottom 3 bits)
             int pieceType = piece & 0b0111;
+            if (pieceType > 6) continue;
             bool isWhitePiece = isWhite(piece);
             
-            double pieceValue = 0;
-            switch(pieceType) {
-                case 0b0001: pieceValue = PAWN_VALUE; break;    // Pawn
-                case 0b0011: pieceValue = KNIGHT_VALUE; break;  // Knight
-                case 0b0100: pieceValue = BISHOP_VALUE; break;  // Bishop
-                case 0b0010: pieceValue = ROOK_VALUE; break;    // Rook
-                case 0b0101: pieceValue = QUEEN_VALUE; break;   // Queen
-                case 0b0110: pieceValue = 0; break;             // King (no material value)
-                default: continue;
-            }
+            double pieceValue = material[pieceType] / 100.0;  // kings have no material value
             
             // Add for white pieces, subtract for black pieces
             if (isWhitePiece) {
@@ -68,80 +95,14 @@ double Evaluation::materialCount(const ChessGame& game) const {
     return count;
 }
 
-// Piece-Square Tables (PST) - bonuses for pieces on good squares
-// Values are from white's perspective (flip for black)
-// Values in centipawns (1 pawn = 100), will be scaled to match material values
-static const int pawnPST[8][8] = {
-    {  0,  0,  0,  0,  0,  0,  0,  0},  // Rank 8 (pawns can't be here)
-    { 98, 134, 61, 95, 68, 126, 34, -11},  // Rank 7 (about to promote!)
-    {-6,   7,  26,  31,  65,  56, 25, -20},  // Rank 6
-    {-14,  13,  6,  21,  23,  12, 17, -23},  // Rank 5
-    {-27,  -2,  -5,  12,  17,   6, 10, -25},  // Rank 4 (center pawns)
-    {-26,  -4,  -4, -10,   3,   3, 33, -12},  // Rank 3
-    {-35,  -1, -20, -23, -15,  24, 38, -22},  // Rank 2 (penalize d/e pawns not moved)
-    {  0,  0,  0,  0,  0,  0,  0,  0}   // Rank 1 (pawns can't be here)
-};
-
-static const int knightPST[8][8] = {
-    {-167, -89, -34, -49,  61, -97, -15, -107},  // Knights on rim are dim
-    {-73, -41,  72,  36,  23,  62,   7,  -17},
-    {-47,  60,  37,  65,  84, 129,  73,   44},
-    {-9,  17,  19,  53,  37,  69,  18,   22},  // Knights love the center
-    {-13,   4,  16,  13,  28,  19,  21,   -8},
-    {-23,  -9,  12,  10,  19,  17,  25,  -16},
-    {-29, -53, -12,  -3,  -1,  18, -14,  -19},
-    {-105, -21, -58, -33, -17, -28, -19,  -23}
-};
-
-static const int bishopPST[8][8] = {
-    {-30,  10, -90, -40, -30, -50,  10, -10},
-    {-30,  30, -10, -10,  50,  80,  30, -50},  // Developed bishops - increased bonus
-    {-20,  60,  60,  60,  55,  70,  60,  10},  // Good diagonals - increased bonus
-    {-5,  20,  35,  70,  60,  60,  20,  10},  // Active bishops - increased bonus
-    {-10,  25,  25,  45,  50,  30,  25,  15},
-    {0,  30,  30,  30,  30,  45,  35,  20},
-    {5,  30,  30,  5,  15,  40,  50,  10},
-    {-40,  -10, -20, -30, -20, -20, -50, -30}  // Starting position - increased penalty
-};
-
-static const int rookPST[8][8] = {
-    {32,  42,  32,  51, 63,  9,  31,  43},
-    {27,  32,  58,  62, 80, 67,  26,  44},
-    {27,  32,  58,  62, 80, 67,  26,  44},
-    {-24, -11,   7,  26, 24, 35,  -8, -20},
-    {-36, -26, -12,  -1,  9, -7,   6, -23},
-    {-45, -25, -16, -17,  3,  0,  -5, -33},
-    {-44, -16, -20,  -9, -1, 11,  -6, -71},
-    {-19, -13,   1,  17, 16,  7, -37, -26}
-};
-
-static const int queenPST[8][8] = {
-    {-28,   0,  29,  12,  59,  44,  43,  45},
-    {-24, -39,  -5,   1, -16,  57,  28,  54},
-    {-13, -17,   7,   8,  29,  56,  47,  57},
-    {-27, -27, -16, -16,  -1,  17,  -2,   1},
-    {-9, -26,  -9, -10,  -2,  -4,   3,  -3},
-    {-14,   2, -11,  -2,  -5,   2,  14,   5},
-    {-35,  -8,  11,   2,   8,  15,  -3,   1},
-    {-1, -18,  -9,  10, -15, -25, -31, -50}
-};
-
-static const int kingMiddlegamePST[8][8] = {
-    {-65,  23,  16, -15, -56, -34,   2,  13},
-    {29,  -1, -20,  -7,  -8,  -4, -38, -29},
-    {-9,  24,   2, -16, -20,   6,  22, -22},
-    {-17, -20, -12, -27, -30, -25, -14, -36},
-    {-49,  -1, -27, -39, -46, -44, -33, -51},
-    {-14, -14, -22, -46, -44, -30, -15, -27},
-    {1,   7,  -8, -64, -43, -16,   9,   8},
-    {-15,  36,  12, -54,   8, -28,  24,  14}
-};
-
-// Evaluate piece positioning using piece-square tables - optimized to use board directly
+// Evaluate piece positioning using piece-square tables, tapered between the
+// middlegame and endgame values by the remaining non-pawn material
 double Evaluation::position(const ChessGame& game) const {
-    double positionValue = 0.0;
+    Score score = 0;
+    int phase = 0;
+    const Score* pst[7];
+    for (int type = 0; type < 7; type++) pst[type] = packedPst(type);
     
-    // Iterate through board array directly (much faster than parsing FEN)
     for (int row = 0; row < 8; row++) {
         for (int col = 0; col < 8; col++) {
             int piece = board[row][col];
@@ -153,28 +114,96 @@ double Evaluation::position(const ChessGame& game) const {
             // For black pieces, flip the row to get correct PST index
             int pstRow = isWhitePiece ? row : (7 - row);
             
-            double pieceValue = 0;
-            // Use piece-square tables (values are in centipawns, so divide by 100 to match pawn=1 scale)
-            switch(pieceType) {
-                case 0b0001: pieceValue = pawnPST[pstRow][col] / 100.0; break;      // Pawn
-                case 0b0011: pieceValue = knightPST[pstRow][col] / 100.0; break;    // Knight
-                case 0b0100: pieceValue = bishopPST[pstRow][col] / 100.0; break;    // Bishop
-                case 0b0010: pieceValue = rookPST[pstRow][col] / 100.0; break;      // Rook
-                case 0b0101: pieceValue = queenPST[pstRow][col] / 100.0; break;     // Queen
-                case 0b0110: pieceValue = kingMiddlegamePST[pstRow][col] / 100.0; break; // King
-                default: continue;
-            }
-            
-            // Add for white pieces, subtract for black pieces
+            // One add covers both phases
             if (isWhitePiece) {
-                positionValue += pieceValue;
+                score += pst[pieceType][pstRow * 8 + col];
             } else {
-                positionValue -= pieceValue;
+                score -= pst[pieceType][pstRow * 8 + col];
             }
+            phase += PHASE_WEIGHT[pieceType];
         }
     }
 
-    return positionValue;
+    // PSTs are in centipawns; divide by 100 to match pawn=1 scale
+    return taper(score, phase) / 100.0;
+}
+
+void Evaluation::evaluateBatch(const PositionBatch& batch, double* out, int threads) const {
+    // Per-piece-code tables with black's entries mirrored and negated, so a
+    // position's material, PST and phase are plain sums over its 64 codes
+    struct BatchTables {
+        array<int, 16> material{};
+        array<int, 16> phase{};
+        array<array<Score, 16>, 64> pst{};  // [square][piece code]
+    };
+    // Rebuilt per call (a few thousand entries) so parameter changes apply
+    const BatchTables tables = [] {
+        BatchTables t;
+        const int* values = evalParams().material;
+        for (int code = 1; code < 16; code++) {
+            int type = code & 0b0111;
+            if (type == 0 || type == 7) continue;
+            bool white = !(code & 0b1000);
+            t.material[code] = white ? values[type] : -values[type];
+            t.phase[code] = PHASE_WEIGHT[type];
+            for (int sq = 0; sq < 64; sq++) {
+                int pstRow = white ? sq / 8 : 7 - sq / 8;
+                Score s = packedPst(type)[pstRow * 8 + sq % 8];
+                t.pst[sq][code] = white ? s : -s;
+            }
+        }
+        return t;
+    }();
+
+    auto work = [&](size_t begin, size_t end) {
+        const size_t BLOCK = 256;
+        int material[BLOCK];
+        Score pst[BLOCK];
+        int phase[BLOCK];
+        for (size_t start = begin; start < end; start += BLOCK) {
+            size_t len = min(BLOCK, end - start);
+            fill(material, material + len, 0);
+            fill(pst, pst + len, 0);
+            fill(phase, phase + len, 0);
+            for (int sq = 0; sq < 64; sq++) {
+                const uint8_t* codes = batch.square(sq) + start;
+                const Score* sqPst = tables.pst[sq].data();
+                for (size_t i = 0; i < len; i++) {
+                    int code = codes[i];
+                    material[i] += tables.material[code];
+                    pst[i] += sqPst[code];
+                    phase[i] += tables.phase[code];
+                }
+            }
+            // Attack maps take a board argument, so they are safe to run per thread
+            for (size_t i = 0; i < len; i++) {
+                int b[8][8];
+                batch.toBoard(start + i, b);
+                // Known endings as in evaluate()
+                const EndgameEntry* ending = findEndgame(computeMaterialKey(b));
+                if (ending && ending->evaluate) {
+                    out[start + i] = ending->value(b, batch.whiteToMove(start + i));
+                    continue;
+                }
+                AttackMaps maps;
+                computeAttackMaps(b, maps);
+                out[start + i] = material[i] / 100.0 + activity(maps) + 0.01*(taper(pst[i], phase[i]) / 100.0);
+                if (ending) out[start + i] *= ending->scale(b, ending->strong);
+            }
+        }
+    };
+
+    size_t n = batch.size();
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+    size_t chunks = min<size_t>(threads, (n + 1023) / 1024);  // at least ~1024 positions per thread
+    if (chunks <= 1) {
+        work(0, n);
+        return;
+    }
+    vector<thread> pool;
+    size_t per = (n + chunks - 1) / chunks;
+    for (size_t begin = 0; begin < n; begin += per) pool.emplace_back(work, begin, min(n, begin + per));
+    for (thread& t : pool) t.join();
 }
 
 // king safety evaluation - simplified version, optimized to use board directly
@@ -314,4 +343,80 @@ double Evaluation::pawnStructure(const ChessGame& game) const {
     }
 
     return pawnStructureValue;
-}
\ No newline at end of file
+}
+double NnueEvaluation::evaluate(const ChessGame& game) const {
+    const EndgameEntry* ending = findEndgame(game.getMaterialKey());
+    if (ending && ending->evaluate) return ending->value(board, game.isWhiteToMove());
+
+    const NnueAccumulator* acc = game.getNnueNetwork() == network ? game.getNnueAccumulator() : nullptr;
+    NnueAccumulator local;
+    if (!acc) {
+        network->refresh(board, local);
+        acc = &local;
+    }
+    int cp = network->evaluate(*acc, game.isWhiteToMove());
+    return (game.isWhiteToMove() ? cp : -cp) / 100.0;
+}
+
+double Evaluation::activity(const AttackMaps& maps) const {
+    double sum = 0.01*(mobility(maps) + kingAttack(maps) + threats(maps));
+    return std::clamp(sum, -LAZY_ACTIVITY_MARGIN, LAZY_ACTIVITY_MARGIN);
+}
+
+// Safe squares each piece attacks: not occupied by own pieces and not
+// covered by enemy pawns
+int Evaluation::mobility(const AttackMaps& maps) const {
+    const EvalParams& params = evalParams();
+    int score[2] = {0, 0};
+    for (int c = 0; c < 2; ++c) {
+        Bitboard area = ~maps.pieces[c][0] & ~maps.attacks[c ^ 1][1];
+        for (int i = 0; i < maps.count[c]; ++i) {
+            const PieceAttacks& p = maps.list[c][i];
+            score[c] += params.mobilityWeight[p.type] * (popCount(p.attacks & area) - params.mobilityBaseline[p.type]);
+        }
+    }
+    return score[0] - score[1];
+}
+
+// Pressure on the squares around each king; only counts once two or more
+// pieces join the attack, and grows quadratically with its weight
+int Evaluation::kingAttack(const AttackMaps& maps) const {
+    const EvalParams& params = evalParams();
+    int penalty[2] = {0, 0};
+    for (int c = 0; c < 2; ++c) {
+        if (maps.kingSquare[c] < 0) continue;
+        Bitboard zone = kingAttacks(maps.kingSquare[c]) | squareBit(maps.kingSquare[c]);
+        int attackers = 0;
+        int units = 0;
+        const int enemy = c ^ 1;
+        for (int i = 0; i < maps.count[enemy]; ++i) {
+            const PieceAttacks& p = maps.list[enemy][i];
+            int hits = popCount(p.attacks & zone);
+            if (hits == 0) continue;
+            attackers++;
+            units += params.kingAttackUnits[p.type] * hits;
+        }
+        if (attackers >= 2) penalty[c] = min(params.kingAttackMax, units * units / 4);
+    }
+    return penalty[1] - penalty[0];
+}
+
+// Undefended pieces under attack and pieces attacked by cheaper ones
+int Evaluation::threats(const AttackMaps& maps) const {
+    const EvalParams& params = evalParams();
+    int penalty[2] = {0, 0};
+    for (int c = 0; c < 2; ++c) {
+        const int enemy = c ^ 1;
+        Bitboard attacked = maps.attacks[enemy][0];
+        Bitboard undefended = ~maps.attacks[c][0];
+        Bitboard pieces = maps.pieces[c][2] | maps.pieces[c][3] | maps.pieces[c][4] | maps.pieces[c][5];
+        Bitboard minorAttacks = maps.attacks[enemy][3] | maps.attacks[enemy][4];
+
+        penalty[c] += params.hangingPawn * popCount(maps.pieces[c][1] & attacked & undefended);
+        penalty[c] += params.hangingPiece * popCount(pieces & attacked & undefended);
+        penalty[c] += params.threatByPawn * popCount(pieces & maps.attacks[enemy][1]);
+        penalty[c] += params.threatByMinor * popCount((maps.pieces[c][2] | maps.pieces[c][5]) & minorAttacks);
+        penalty[c] += params.threatByRook * popCount(maps.pieces[c][5] & maps.attacks[enemy][2]);
+    }
+    return penalty[1] - penalty[0];
+}
@@ -2,6 +2,8 @@
 #include "board.hpp"
 #include "game.hpp"
 #include "moveGeneration.hpp"
+#include "attackMaps.hpp"
+#include "positionBatch.hpp"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -13,17 +15,19 @@ class ChessGame;
 
 class Evaluation {
 protected:
-    // Piece values
-    static constexpr double PAWN_VALUE = 1.0;
-    static constexpr double KNIGHT_VALUE = 3.0;
-    static constexpr double BISHOP_VALUE = 3.0;
-    static constexpr double ROOK_VALUE = 5.0;
-    static constexpr double QUEEN_VALUE = 9.0;
+    // Piece values, PSTs and term weights come from evalParams() (evalParams.hpp)
     
     // Evaluation components (protected for subclass access)
     double position(const ChessGame& game) const;
     double kingsafety(const ChessGame& game) const;
     double pawnStructure(const ChessGame& game) const;
+    
+    // Attack-map terms, in centipawns (white positive); share one computeAttackMaps pass
+    int mobility(const AttackMaps& maps) const;
+    int kingAttack(const AttackMaps& maps) const;
+    int threats(const AttackMaps& maps) const;
+    // Their sum in pawns, clamped to +-LAZY_ACTIVITY_MARGIN so the lazy exits stay bounds
+    double activity(const AttackMaps& maps) const;
 
 public:
     Evaluation() = default;
@@ -35,4 +39,37 @@ public:
     // Main evaluation function
     // Returns positive for white advantage, negative for black advantage
     double evaluate(const ChessGame& game) const;
-};
\ No newline at end of file
+    
+    // Lazy evaluation for a (alpha, beta) window: returns as soon as the terms
+    // computed so far plus a bound on the rest fall outside it. An early
+    // result is a bound, not the exact score: at or below alpha it is an
+    // upper bound, at or above beta a lower bound. Inside the window the
+    // result equals evaluate(game).
+    double evaluate(const ChessGame& game, double alpha, double beta) const;
+    
+    // Evaluate many positions in one call (pawns, white positive). Same terms as
+    // evaluate() except kingsafety() and pawnStructure(), which read the global
+    // board; known endings get their exact score or scale factor as there.
+    // Material and PSTs run structure-of-arrays over the batch; positions are
+    // split across 'threads' (0 = all cores). 'out' holds batch.size() values.
+    void evaluateBatch(const PositionBatch& batch, double* out, int threads = 0) const;
+    
+    // Largest contribution (pawns) assumed for the terms skipped by the lazy exits
+    static constexpr double LAZY_ACTIVITY_MARGIN = 3.0;    // mobility + king attack + threats, see activity()
+    static constexpr double LAZY_POSITIONAL_MARGIN = 0.25; // PST + king safety + pawn structure
+};
+
+// NNUE evaluation (see nnue.hpp). Uses the game's incremental accumulator when
+// the same network is attached with ChessGame::attachNnue, otherwise refreshes
+// one from the board. Search with it via BasicEngine<NnueEvaluation>
+// (chess_uci's UseNNUE and NNUEFile options).
+class NnueEvaluation : public Evaluation {
+public:
+    explicit NnueEvaluation(const NnueNetwork& network) : network(&network) {}
+
+    // Same sign convention as Evaluation::evaluate (pawns, white positive)
+    double evaluate(const ChessGame& game) const;
+
+private:
+    const NnueNetwork* network;
+};
@@ -50,6 +50,8 @@ void ChessGame::startNewGame() {
     
     // Compute initial Zobrist hash
     zobristHash = computeZobristHash();
+    materialKey = computeMaterialKey(board);
+    nnueRefresh();
 }
 
 void ChessGame::displayBoard() const {
@@ -163,6 +165,8 @@ bool ChessGame::makePlayerMove(const string& moveStr) {
     // Execute the move
     makeMove(*matchingMove);
     gameHistory.push_back(*matchingMove);
+    materialKey = computeMaterialKey(board);
+    nnueRefresh();
     
     // Switch turns
     isWhiteTurn = !isWhiteTurn;
@@ -270,6 +274,8 @@ bool ChessGame::makePlayerMove(const string& moveStr, char promotionPiece) {
     // Execute the move
     makeMove(*matchingMove);
     gameHistory.push_back(*matchingMove);
+    materialKey = computeMaterialKey(board);
+    nnueRefresh();
     
     // Switch turns
     isWhiteTurn = !isWhiteTurn;
@@ -319,7 +325,8 @@ void ChessGame::makeMoveForEngine(const Move& move) {
         halfmoveClock,                     // halfmoveClockBefore
         fullmoveNumber,                    // fullmoveNumberBefore
         currentFEN,                        // fenBefore
-        zobristHash                        // zobristHashBefore
+        zobristHash,                       // zobristHashBefore
+        materialKey                        // materialKeyBefore
     };
     
     undoStack.push_back(info);
@@ -396,6 +403,9 @@ void ChessGame::makeMoveForEngine(const Move& move) {
     int finalPiece = board[move.targetRow][move.targetColumn];
     zobristHash ^= zobristTable[destSquare][getZobristIndex(finalPiece)];
     
+    if (capturedPiece != EMPTY) materialKey -= materialKeyOf(capturedPiece);
+    if (finalPiece != movingPiece) materialKey += materialKeyOf(finalPiece) - materialKeyOf(movingPiece);
+    
     // 8. For castling, add rook to destination square (after makeMove)
     if (move.moveType == CASTLING_KINGSIDE) {
         int rookDest = move.startRow * 8 + 5;
@@ -422,6 +432,30 @@ void ChessGame::makeMoveForEngine(const Move& move) {
         zobristHash ^= zobristEnPassant[enPassantTargetCol];
     }
     
+    // NNUE: push an accumulator updated with just the pieces this move touched
+    if (nnueNetwork) {
+        NnueDirty dirty;
+        if (finalPiece != movingPiece) {  // promotion
+            dirty.add(movingPiece, srcSquare, -1);
+            dirty.add(finalPiece, -1, destSquare);
+        } else {
+            dirty.add(movingPiece, srcSquare, destSquare);
+        }
+        if (capturedPiece != EMPTY) {
+            int capSquare = (move.moveType == EN_PASSANT)
+                ? (move.startRow * 8 + move.targetColumn)
+                : destSquare;
+            dirty.add(capturedPiece, capSquare, -1);
+        }
+        if (move.moveType == CASTLING_KINGSIDE) {
+            dirty.add(board[move.startRow][5], move.startRow * 8 + 7, move.startRow * 8 + 5);
+        } else if (move.moveType == CASTLING_QUEENSIDE) {
+            dirty.add(board[move.startRow][3], move.startRow * 8 + 0, move.startRow * 8 + 3);
+        }
+        nnueAccumulators.emplace_back();
+        nnueNetwork->update(nnueAccumulators[nnueAccumulators.size() - 2], nnueAccumulators.back(), board, dirty);
+    }
+    
     // Mark FEN as needing update
     fenNeedsUpdate = true;
     
@@ -492,6 +526,8 @@ bool ChessGame::makeEngineMove(const Move& move) {
     
     // Recompute Zobrist hash after making the move
     zobristHash = computeZobristHash();
+    materialKey = computeMaterialKey(board);
+    nnueRefresh();
     
     // Increment fullmove number after black's move
     if (isWhiteTurn) {
@@ -798,7 +834,7 @@ void ChessGame::loadFEN(const string& fen) {
     
     istringstream ss(fen);
     string piecePlacement, activeColor, castling, enPassant;
-    int halfmove, fullmove;
+    int halfmove = 0, fullmove = 1;  // Move counters are optional in EPD-style strings
     
     ss >> piecePlacement >> activeColor >> castling >> enPassant >> halfmove >> fullmove;
     
@@ -830,16 +866,14 @@ void ChessGame::loadFEN(const string& fen) {
     // 4. En passant target square
     if (enPassant != "-") {
         int epRow, epCol;
-        if (parseCoordinate(enPassant, epRow, epCol)) {
-            // En passant target square is where the pawn would land
-            // We need to set the target behind the pawn that just moved
-            if (epRow == 2) {  // White pawn moved from row 6 to row 4
-                enPassantTargetRow = 3;
-                enPassantTargetCol = epCol;
-            } else if (epRow == 5) {  // Black pawn moved from row 1 to row 3
-                enPassantTargetRow = 4;
-                enPassantTargetCol = epCol;
-            }
+        // The FEN square is the one the capturing pawn lands on (behind the pawn
+        // that just moved), which is exactly what move generation expects
+        if (parseCoordinate(enPassant, epRow, epCol) && (epRow == 2 || epRow == 5)) {
+            enPassantTargetRow = epRow;
+            enPassantTargetCol = epCol;
+        } else {
+            enPassantTargetRow = -1;
+            enPassantTargetCol = -1;
         }
     } else {
         enPassantTargetRow = -1;
@@ -862,6 +896,8 @@ void ChessGame::loadFEN(const string& fen) {
     
     // Recompute zobrist hash from new position
     zobristHash = computeZobristHash();
+    materialKey = computeMaterialKey(board);
+    nnueRefresh();
 }
 
 bool ChessGame::isDrawByRepetition() const {
@@ -882,88 +918,40 @@ bool ChessGame::isDrawByFiftyMoveRule() const {
 }
 
 bool ChessGame::isDrawByInsufficientMaterial() const {
-    // Count pieces on the board
-    int whiteBishops = 0, blackBishops = 0;
-    int whiteKnights = 0, blackKnights = 0;
-    int whitePawns = 0, blackPawns = 0;
-    int whiteRooks = 0, blackRooks = 0;
-    int whiteQueens = 0, blackQueens = 0;
-    
-    // Track bishop square colors (true = light square, false = dark square)
-    bool whiteBishopOnLight = false, whiteBishopOnDark = false;
-    bool blackBishopOnLight = false, blackBishopOnDark = false;
-    
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            int piece = board[row][col];
-            if (isEmpty(piece)) continue;
-            
-            int pieceType = piece & 0b0111;
-            bool isLightSquare = (row + col) % 2 == 0;
-            
-            if (isWhite(piece)) {
-                switch (pieceType) {
-                    case 0b0001: whitePawns++; break;
-                    case 0b0010: whiteRooks++; break;
-                    case 0b0011: whiteKnights++; break;
-                    case 0b0100: 
-                        whiteBishops++; 
-                        if (isLightSquare) whiteBishopOnLight = true;
-                        else whiteBishopOnDark = true;
-                        break;
-                    case 0b0101: whiteQueens++; break;
-                }
-            } else {
-                switch (pieceType) {
-                    case 0b0001: blackPawns++; break;
-                    case 0b0010: blackRooks++; break;
-                    case 0b0011: blackKnights++; break;
-                    case 0b0100: 
-                        blackBishops++; 
-                        if (isLightSquare) blackBishopOnLight = true;
-                        else blackBishopOnDark = true;
-                        break;
-                    case 0b0101: blackQueens++; break;
-                }
-            }
-        }
-    }
+    // Piece counts come from the material key; only KB vs KB needs the board
+    const MaterialKey PAWNS_ROOKS_QUEENS =
+        (0xFULL << materialShift(WHITE_PAWN)) | (0xFULL << materialShift(WHITE_ROOK)) |
+        (0xFULL << materialShift(WHITE_QUEEN)) | (0xFULL << materialShift(BLACK_PAWN)) |
+        (0xFULL << materialShift(BLACK_ROOK)) | (0xFULL << materialShift(BLACK_QUEEN));
     
     // If there are pawns, rooks, or queens, checkmate is possible
-    if (whitePawns > 0 || blackPawns > 0 || 
-        whiteRooks > 0 || blackRooks > 0 || 
-        whiteQueens > 0 || blackQueens > 0) {
+    if (materialKey & PAWNS_ROOKS_QUEENS) {
         return false;
     }
     
-    // King vs King
-    if (whiteKnights == 0 && blackKnights == 0 && 
-        whiteBishops == 0 && blackBishops == 0) {
-        return true;
-    }
-    
-    // King + Bishop vs King
-    if (whiteKnights == 0 && blackKnights == 0 &&
-        ((whiteBishops == 1 && blackBishops == 0) ||
-         (whiteBishops == 0 && blackBishops == 1))) {
-        return true;
-    }
+    int whiteKnights = materialCount(materialKey, WHITE_KNIGHT);
+    int blackKnights = materialCount(materialKey, BLACK_KNIGHT);
+    int whiteBishops = materialCount(materialKey, WHITE_BISHOP);
+    int blackBishops = materialCount(materialKey, BLACK_BISHOP);
+    int minors = whiteKnights + blackKnights + whiteBishops + blackBishops;
     
-    // King + Knight vs King
-    if (whiteBishops == 0 && blackBishops == 0 &&
-        ((whiteKnights == 1 && blackKnights == 0) ||
-         (whiteKnights == 0 && blackKnights == 1))) {
+    // King vs King, King + minor piece vs King
+    if (minors <= 1) {
         return true;
     }
     
     // King + Bishop vs King + Bishop (same color bishops)
-    if (whiteKnights == 0 && blackKnights == 0 &&
-        whiteBishops == 1 && blackBishops == 1) {
-        // Check if both bishops are on the same color squares
-        if ((whiteBishopOnLight && blackBishopOnLight) ||
-            (whiteBishopOnDark && blackBishopOnDark)) {
-            return true;
+    if (minors == 2 && whiteBishops == 1 && blackBishops == 1) {
+        // Track bishop square colors (true = light square, false = dark square)
+        bool whiteBishopOnLight = false, blackBishopOnLight = false;
+        for (int row = 0; row < 8; row++) {
+            for (int col = 0; col < 8; col++) {
+                bool isLightSquare = (row + col) % 2 == 0;
+                if (board[row][col] == WHITE_BISHOP) whiteBishopOnLight = isLightSquare;
+                if (board[row][col] == BLACK_BISHOP) blackBishopOnLight = isLightSquare;
+            }
         }
+        return whiteBishopOnLight == blackBishopOnLight;
     }
     
     return false;
@@ -997,6 +985,7 @@ void ChessGame::undoMove() {
     
     // Restore zobrist hash (much faster than recalculating)
     zobristHash = info.zobristHashBefore;
+    materialKey = info.materialKeyBefore;
     
     // Undo the move on the board
     Move& move = info.move;
@@ -1057,6 +1046,13 @@ void ChessGame::undoMove() {
         gameHistory.back().targetColumn == move.targetColumn) {
         gameHistory.pop_back();
     }
+    
+    // NNUE: the previous accumulator is still on the stack unless the move
+    // was made outside makeMoveForEngine
+    if (nnueNetwork) {
+        if (nnueAccumulators.size() > 1) nnueAccumulators.pop_back();
+        else nnueRefresh();
+    }
     auto _uend = high_resolution_clock::now();
     long long _uus = duration_cast<microseconds>(_uend - _ustart).count();
     Engine::addUndoMoveTime(_uus);
@@ -1065,6 +1061,24 @@ void ChessGame::undoMove() {
 // Clear the undo stack (used after engine search completes)
 void ChessGame::clearUndoStack() {
     undoStack.clear();
+    if (nnueAccumulators.size() > 1) {
+        NnueAccumulator current = nnueAccumulators.back();
+        nnueAccumulators.assign(1, current);
+    }
+}
+
+void ChessGame::attachNnue(const NnueNetwork* network) {
+    nnueNetwork = network;
+    nnueRefresh();
+}
+
+// Rebuild the accumulator stack from the current board
+void ChessGame::nnueRefresh() {
+    nnueAccumulators.clear();
+    if (!nnueNetwork) return;
+    nnueAccumulators.reserve(128);
+    nnueAccumulators.emplace_back();
+    nnueNetwork->refresh(board, nnueAccumulators.back());
 }
 
 // Make a null move (pass turn) for null move pruning
@@ -1,6 +1,8 @@
 #pragma once
 #include "board.hpp"
 #include "moveGeneration.hpp"
+#include "nnue.hpp"
+#include "materialKey.hpp"
 #include <string>
 #include <vector>
 #include <map>
@@ -24,6 +26,7 @@ struct UndoInfo {
     int fullmoveNumberBefore;
     string fenBefore;
     uint64_t zobristHashBefore;  // Store zobrist hash for fast undo
+    MaterialKey materialKeyBefore;
 };
 
 class ChessGame {
@@ -47,6 +50,9 @@ private:
     static uint64_t zobristSideToMove;     // Toggle for black to move
     static bool zobristInitialized;
     
+    // Piece counts (materialKey.hpp), updated by captures and promotions
+    MaterialKey materialKey;
+    
     // Position history for threefold repetition (position -> count)
     map<string, int> positionHistory;
     
@@ -57,6 +63,11 @@ private:
     int nullMoveOldEnPassantRow;
     int nullMoveOldEnPassantCol;
     
+    // NNUE accumulators, one per undo level (only kept while a network is attached)
+    const NnueNetwork* nnueNetwork = nullptr;
+    vector<NnueAccumulator> nnueAccumulators;
+    void nnueRefresh();
+    
     // Zobrist hashing initialization
     void initZobrist();
 
@@ -72,6 +83,7 @@ public:
     // Zobrist hash functions (public for debugging)
     uint64_t computeZobristHash() const;
     uint64_t getZobristHash() const { return zobristHash; }
+    MaterialKey getMaterialKey() const { return materialKey; }
     
     // Move handling
     bool makePlayerMove(const string& moveStr);
@@ -86,6 +98,11 @@ public:
     void makeNullMove();    // Switch turn without moving (for null move pruning)
     void undoNullMove();    // Undo null move
     
+    // NNUE: attach a network (or nullptr) to keep accumulators updated incrementally
+    void attachNnue(const NnueNetwork* network);
+    const NnueNetwork* getNnueNetwork() const { return nnueNetwork; }
+    const NnueAccumulator* getNnueAccumulator() const { return nnueAccumulators.empty() ? nullptr : &nnueAccumulators.back(); }
+    
     // Input/Output
     void displayBoard() const;
     void displayLegalMoves() const;
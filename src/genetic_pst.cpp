@@ -1,6 +1,7 @@
 #include "game.hpp"
-#include "engine.hpp"
+#include "engine_impl.hpp"  // BasicEngine<GenomeEvaluation>
 #include "evaluation.hpp"
+#include "evalParams.hpp"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -85,6 +86,21 @@ struct Genome {
         
         file.close();
     }
+
+    // The PSTs as an evaluation parameter file (UCI EvalFile / EVAL_PARAMS_FILE).
+    // The genome tables are untapered, so they go into both mg and eg; the
+    // weights have no equivalent and everything else keeps its default.
+    bool saveParamsFile(const string& filename) const {
+        EvalParams params = defaultEvalParams();
+        const int (*tables[7])[8] = {nullptr, pawnPST, rookPST, knightPST, bishopPST, queenPST, kingPST};
+        for (int type = 1; type <= 6; type++) {
+            for (int sq = 0; sq < 64; sq++) {
+                params.pstMg[type][sq] = tables[type][sq / 8][sq % 8];
+                params.pstEg[type][sq] = tables[type][sq / 8][sq % 8];
+            }
+        }
+        return saveEvalParams(filename, params);
+    }
 };
 
 // Custom evaluation class using genome
@@ -161,8 +177,8 @@ string playGame(Genome& g1, Genome& g2, bool g1PlaysWhite, int depth) {
     GenomeEvaluation eval1(g1);
     GenomeEvaluation eval2(g2);
     
-    Engine engine1(eval1);
-    Engine engine2(eval2);
+    BasicEngine<GenomeEvaluation> engine1(eval1, Engine::SELFPLAY_HASH_MB);
+    BasicEngine<GenomeEvaluation> engine2(eval2, Engine::SELFPLAY_HASH_MB);
     
     int moveCount = 0;
     int maxMoves = 120;
@@ -170,7 +186,7 @@ string playGame(Genome& g1, Genome& g2, bool g1PlaysWhite, int depth) {
     while (!game.isGameOver() && moveCount < maxMoves) {
         bool isWhiteTurn = game.isWhiteToMove();
         
-        Engine* currentEngine = nullptr;
+        BasicEngine<GenomeEvaluation>* currentEngine = nullptr;
         if ((isWhiteTurn && g1PlaysWhite) || (!isWhiteTurn && !g1PlaysWhite)) {
             currentEngine = &engine1;
         } else {
@@ -396,6 +412,7 @@ int main() {
             best = population[0];
             best.generation = genNum + 1;
             best.saveToFile("best_genome_gen" + to_string(genNum + 1) + ".txt");
+            best.saveParamsFile("best_genome_gen" + to_string(genNum + 1) + ".params");
             cout << "*** New best saved! ***\n";
         }
         
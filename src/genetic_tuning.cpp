@@ -1,5 +1,5 @@
 #include "game.hpp"
-#include "engine.hpp"
+#include "engine_impl.hpp"  // BasicEngine<GeneticEvaluation>
 #include "evaluation.hpp"
 #include <iostream>
 #include <vector>
@@ -61,8 +61,8 @@ string playGame(Chromosome& c1, Chromosome& c2, bool c1PlaysWhite, int depth, mt
     GeneticEvaluation eval1(c1);
     GeneticEvaluation eval2(c2);
     
-    Engine engine1(eval1);
-    Engine engine2(eval2);
+    BasicEngine<GeneticEvaluation> engine1(eval1, Engine::SELFPLAY_HASH_MB);
+    BasicEngine<GeneticEvaluation> engine2(eval2, Engine::SELFPLAY_HASH_MB);
     
     int moveCount = 0;
     int maxMoves = 80;  // Shorter games
@@ -73,7 +73,7 @@ string playGame(Chromosome& c1, Chromosome& c2, bool c1PlaysWhite, int depth, mt
     while (!game.isGameOver() && moveCount < maxMoves) {
         bool isWhiteTurn = game.isWhiteToMove();
         
-        Engine* currentEngine = nullptr;
+        BasicEngine<GeneticEvaluation>* currentEngine = nullptr;
         if ((isWhiteTurn && c1PlaysWhite) || (!isWhiteTurn && !c1PlaysWhite)) {
             currentEngine = &engine1;
         } else {
@@ -39,6 +39,7 @@ int main() {
     bool enginePlaysWhite = (mode == 3);
     bool enginePlaysBlack = (mode == 2 || mode == 3);
     int engineDepth = 3; // Search depth for the engine
+    long long engineMoveTimeMs = 5000; // Upper bound on thinking time per move
     
     Engine engine;
     
@@ -60,7 +61,10 @@ int main() {
             }
             cout << endl;
             
-            Move bestMove = engine.getBestMove(game, engineDepth);
+            SearchLimits limits;
+            limits.depth = engineDepth;
+            limits.movetimeMs = engineMoveTimeMs;
+            Move bestMove = engine.getBestMove(game, limits);
             
             if (bestMove.startRow == -1) {
                 cout << "Engine has no legal moves!\n";
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+// Material signature: how many of each piece kind are on the board, 4 bits
+// per kind (white pawn..king in nibbles 0-5, black in 6-11, in board piece
+// code order). Positions with the same pieces share a key wherever they
+// stand, and a capture or promotion updates it with one add.
+using MaterialKey = uint64_t;
+
+constexpr int materialShift(int piece) {
+    return 4 * (((piece & 0b1000) ? 6 : 0) + (piece & 0b0111) - 1);
+}
+
+// Key contribution of one piece (board code, colour bit included)
+constexpr MaterialKey materialKeyOf(int piece) {
+    return MaterialKey(1) << materialShift(piece);
+}
+
+constexpr int materialCount(MaterialKey key, int piece) {
+    return static_cast<int>((key >> materialShift(piece)) & 0xF);
+}
+
+inline MaterialKey computeMaterialKey(const int b[8][8]) {
+    MaterialKey key = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        int piece = b[sq / 8][sq % 8];
+        if (piece != 0) key += materialKeyOf(piece);
+    }
+    return key;
+}
@@ -1,5 +1,6 @@
 #include "moveGeneration.hpp"
 #include <iostream>
+#include <algorithm>
 
 using namespace std;
 
@@ -320,6 +321,9 @@ vector<Move> generatePawnMoves(int sRow, int sCol){
                 int targetRow = sRow - 1;
                 int targetCol = sCol + i;
 
+                // Check bounds
+                if(targetCol < 0 || targetCol > 7) continue;
+
                 //take diagonally
                 if(isBlack(board[targetRow][targetCol]) && targetCol != sCol){
                     // Check for promotion
@@ -484,9 +488,9 @@ vector<Move> generateBasicMovesForPiece(int row, int col) {
                 
                 // Double move from starting position
                 if ((isWhitePawn && row == 6) || (!isWhitePawn && row == 1)) {
-                    targetRow = row + 2 * direction;
-                    if (targetRow >= 0 && targetRow < 8 && isEmpty(board[targetRow][col])) {
-                        moves.push_back(Move(row, col, targetRow, col));
+                    int doubleRow = row + 2 * direction;
+                    if (doubleRow >= 0 && doubleRow < 8 && isEmpty(board[doubleRow][col])) {
+                        moves.push_back(Move(row, col, doubleRow, col));
                     }
                 }
             }
@@ -833,3 +837,190 @@ void updateGameState(const Move& move) {
         }
     }
 }
+
+// ---------------------------------------------------------------------------
+// Static exchange evaluation
+// ---------------------------------------------------------------------------
+
+// Material value of a piece in pawns (king only matters as the last attacker)
+double seePieceValue(int piece) {
+    switch(piece & 0b0111) {
+        case 0b0001: return 1.0;   // pawn
+        case 0b0011: return 3.0;   // knight
+        case 0b0100: return 3.0;   // bishop
+        case 0b0010: return 5.0;   // rook
+        case 0b0101: return 9.0;   // queen
+        case 0b0110: return 100.0; // king
+        default: return 0.0;
+    }
+}
+
+// Find the least valuable piece of the given colour attacking (row, col) on 'b'.
+// Sliders are found by walking rays from the target, so pieces already removed
+// from 'b' during an exchange uncover the x-ray attackers behind them.
+static bool leastValuableAttacker(const int b[8][8], int row, int col, bool byWhite, int& outRow, int& outCol) {
+    auto own = [byWhite](int piece) { return !isEmpty(piece) && (isWhite(piece) == byWhite); };
+    auto onBoard = [](int r, int c) { return r >= 0 && r < 8 && c >= 0 && c < 8; };
+
+    // Pawns: white pawns attack upwards (towards row 0), so they sit one row below the target
+    int pawnRow = byWhite ? row + 1 : row - 1;
+    for(int dc = -1; dc <= 1; dc += 2) {
+        int c = col + dc;
+        if(onBoard(pawnRow, c) && own(b[pawnRow][c]) && (b[pawnRow][c] & 0b0111) == 0b0001) {
+            outRow = pawnRow; outCol = c; return true;
+        }
+    }
+
+    static const int knightOffsets[8][2] = {{-2,-1},{-2,1},{-1,-2},{-1,2},{1,-2},{1,2},{2,-1},{2,1}};
+    for(const auto& o : knightOffsets) {
+        int r = row + o[0], c = col + o[1];
+        if(onBoard(r, c) && own(b[r][c]) && (b[r][c] & 0b0111) == 0b0011) {
+            outRow = r; outCol = c; return true;
+        }
+    }
+
+    // Nearest piece along each ray: index 0-3 diagonal, 4-7 orthogonal
+    static const int rays[8][2] = {{-1,-1},{-1,1},{1,-1},{1,1},{-1,0},{1,0},{0,-1},{0,1}};
+    int rayRow[8], rayCol[8];
+    for(int i = 0; i < 8; i++) {
+        rayRow[i] = -1;
+        int r = row + rays[i][0], c = col + rays[i][1];
+        while(onBoard(r, c)) {
+            if(!isEmpty(b[r][c])) {
+                if(own(b[r][c])) { rayRow[i] = r; rayCol[i] = c; }
+                break;
+            }
+            r += rays[i][0]; c += rays[i][1];
+        }
+    }
+
+    // Bishops, then rooks, then queens
+    const int sliderOrder[3] = {0b0100, 0b0010, 0b0101};
+    for(int type : sliderOrder) {
+        for(int i = 0; i < 8; i++) {
+            if(rayRow[i] == -1) continue;
+            bool diagonal = i < 4;
+            if(type == 0b0100 && !diagonal) continue;
+            if(type == 0b0010 && diagonal) continue;
+            if((b[rayRow[i]][rayCol[i]] & 0b0111) == type) {
+                outRow = rayRow[i]; outCol = rayCol[i]; return true;
+            }
+        }
+    }
+
+    for(int dr = -1; dr <= 1; dr++) {
+        for(int dc = -1; dc <= 1; dc++) {
+            int r = row + dr, c = col + dc;
+            if((dr || dc) && onBoard(r, c) && own(b[r][c]) && (b[r][c] & 0b0111) == 0b0110) {
+                outRow = r; outCol = c; return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Material outcome (in pawns, for the side making 'move') of the capture sequence
+// on the target square when both sides always recapture with their least valuable
+// attacker and may stop whenever continuing would lose material. Pins are ignored.
+double staticExchangeEval(const Move& move) {
+    int b[8][8];
+    for(int r = 0; r < 8; r++)
+        for(int c = 0; c < 8; c++)
+            b[r][c] = board[r][c];
+
+    const int row = move.targetRow, col = move.targetColumn;
+    int mover = b[move.startRow][move.startColumn];
+    bool sideWhite = isWhite(mover);
+
+    double gain[32];
+    int d = 0;
+    if(move.moveType == EN_PASSANT) {
+        gain[0] = 1.0;
+        b[move.startRow][move.targetColumn] = EMPTY;
+    } else {
+        gain[0] = seePieceValue(b[row][col]);
+    }
+    // The piece now standing on the target square and what it is worth
+    double onSquare = seePieceValue(mover);
+    if(move.moveType == PAWN_PROMOTION) {
+        double promoValue = seePieceValue(move.promotionPiece);
+        gain[0] += promoValue - 1.0;
+        onSquare = promoValue;
+    }
+    b[move.startRow][move.startColumn] = EMPTY;
+    b[row][col] = mover;
+
+    bool side = !sideWhite;
+    int ar, ac;
+    while(d < 31 && leastValuableAttacker(b, row, col, side, ar, ac)) {
+        int attacker = b[ar][ac];
+        // A king may only recapture if the square is no longer defended
+        if((attacker & 0b0111) == 0b0110) {
+            int tmpR, tmpC;
+            b[ar][ac] = EMPTY;
+            bool defended = leastValuableAttacker(b, row, col, !side, tmpR, tmpC);
+            b[ar][ac] = attacker;
+            if(defended) break;
+        }
+        d++;
+        gain[d] = onSquare - gain[d - 1];
+        b[ar][ac] = EMPTY;
+        b[row][col] = attacker;
+        onSquare = seePieceValue(attacker);
+        side = !side;
+    }
+    while(d > 0) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+        d--;
+    }
+    return gain[0];
+}
+
+// Does 'move' put the opponent's king in check? Decided from the move itself:
+// the move is applied to a copy of the board and the enemy king square is
+// scanned for attackers, which covers direct checks by the moved (or promoted)
+// piece, discovered checks through the vacated square, en passant and castling
+// rook checks, without generating the opponent's moves.
+bool moveGivesCheck(const Move& move) {
+    int b[8][8];
+    for(int r = 0; r < 8; r++)
+        for(int c = 0; c < 8; c++)
+            b[r][c] = board[r][c];
+
+    int mover = b[move.startRow][move.startColumn];
+    bool moverWhite = isWhite(mover);
+    b[move.startRow][move.startColumn] = EMPTY;
+    switch(move.moveType) {
+        case CASTLING_KINGSIDE:
+            b[move.targetRow][move.targetColumn] = mover;
+            b[move.targetRow][5] = b[move.targetRow][7];
+            b[move.targetRow][7] = EMPTY;
+            break;
+        case CASTLING_QUEENSIDE:
+            b[move.targetRow][move.targetColumn] = mover;
+            b[move.targetRow][3] = b[move.targetRow][0];
+            b[move.targetRow][0] = EMPTY;
+            break;
+        case EN_PASSANT:
+            b[move.targetRow][move.targetColumn] = mover;
+            b[move.startRow][move.targetColumn] = EMPTY;
+            break;
+        case PAWN_PROMOTION:
+            b[move.targetRow][move.targetColumn] = move.promotionPiece;
+            break;
+        default:
+            b[move.targetRow][move.targetColumn] = mover;
+            break;
+    }
+
+    int enemyKing = moverWhite ? BLACK_KING : WHITE_KING;
+    for(int r = 0; r < 8; r++) {
+        for(int c = 0; c < 8; c++) {
+            if(b[r][c] == enemyKing) {
+                int ar, ac;
+                return leastValuableAttacker(b, r, c, moverWhite, ar, ac);
+            }
+        }
+    }
+    return false;
+}
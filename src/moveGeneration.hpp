@@ -61,6 +61,14 @@ bool isSquareAttacked(int row, int col, bool byWhite);
 bool isKingInCheck(bool whiteKing);
 bool isMoveLegal(const Move& move);
 
+// Static exchange evaluation: material result (in pawns) for the side playing
+// 'move' after the best sequence of recaptures on its target square
+double staticExchangeEval(const Move& move);
+double seePieceValue(int piece);
+
+// True if 'move' (not yet made) checks the opponent's king, directly or by discovery
+bool moveGivesCheck(const Move& move);
+
 // Main function - generates only legal moves
 vector<Move> generateLegalMoves(bool isWhiteTurn);
 
@@ -0,0 +1,281 @@
+#include "nnue.hpp"
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+#if defined(__AVX2__) || defined(__SSSE3__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Engine square (row 0 = rank 8) -> feature square from 'perspective's view
+static inline int orientSquare(int sq, int perspective) {
+    int s = (7 - sq / 8) * 8 + sq % 8;  // a1 = 0
+    return perspective == 0 ? s : s ^ 56;
+}
+
+// 0..9: P, N, B, R, Q of the perspective's own colour (even) or the opponent's (odd)
+static inline int pieceIndex(int piece, int perspective) {
+    static const int typeIndex[8] = {-1, 0, 3, 1, 2, 4, -1, -1};  // board codes P=1 R=2 N=3 B=4 Q=5
+    bool white = !(piece & 0b1000);
+    bool own = white == (perspective == 0);
+    return typeIndex[piece & 0b0111] * 2 + (own ? 0 : 1);
+}
+
+static inline int featureIndex(int perspective, int kingSq, int piece, int sq) {
+    return orientSquare(kingSq, perspective) * 640 + pieceIndex(piece, perspective) * 64 + orientSquare(sq, perspective);
+}
+
+static inline bool isKing(int piece) { return (piece & 0b0111) == 0b0110; }
+
+static int findKing(const int b[8][8], int perspective) {
+    int king = perspective == 0 ? 0b0110 : 0b1110;
+    for (int sq = 0; sq < 64; ++sq) {
+        if (b[sq / 8][sq % 8] == king) return sq;
+    }
+    return 0;
+}
+
+// --- SIMD kernels -----------------------------------------------------------
+
+static inline void addWeights(int16_t* acc, const int16_t* w) {
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, b));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, b));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i) acc[i] = static_cast<int16_t>(acc[i] + w[i]);
+#endif
+}
+
+static inline void subWeights(int16_t* acc, const int16_t* w) {
+#if defined(__AVX2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, b));
+    }
+#elif defined(__SSE2__)
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, b));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i) acc[i] = static_cast<int16_t>(acc[i] - w[i]);
+#endif
+}
+
+// int16 accumulator -> uint8 activations clipped to 0..127
+static inline void clipToBytes(const int16_t* in, uint8_t* out) {
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi16(127);
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(in + i + 16));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), max);
+        b = _mm256_min_epi16(_mm256_max_epi16(b, zero), max);
+        // packus works per 128-bit lane; restore element order afterwards
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(out + i), packed);
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(127);
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(in + i + 8));
+        a = _mm_min_epi16(_mm_max_epi16(a, zero), max);
+        b = _mm_min_epi16(_mm_max_epi16(b, zero), max);
+        _mm_store_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(a, b));
+    }
+#else
+    for (int i = 0; i < NNUE_HIDDEN; ++i) out[i] = static_cast<uint8_t>(std::clamp<int>(in[i], 0, 127));
+#endif
+}
+
+// Dot product of uint8 activations with int8 weights (length a multiple of 32)
+static inline int32_t dotBytes(const uint8_t* x, const int8_t* w, int n) {
+#if defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < n; i += 32) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + i));
+        // 127 * 128 * 2 fits in int16, so maddubs can't saturate here
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+#elif defined(__SSSE3__)
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < n; i += 16) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(x + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(a, b), ones));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+#else
+    int32_t sum = 0;
+    for (int i = 0; i < n; ++i) sum += static_cast<int32_t>(x[i]) * w[i];
+    return sum;
+#endif
+}
+
+const char* NnueNetwork::simdName() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSSE3__)
+    return "ssse3";
+#else
+    return "scalar";
+#endif
+}
+
+// --- Network ----------------------------------------------------------------
+
+NnueNetwork::NnueNetwork()
+    : ftBias(NNUE_HIDDEN, 0),
+      ftWeights(static_cast<size_t>(NNUE_FEATURES) * NNUE_HIDDEN, 0),
+      l1Bias(NNUE_L1, 0),
+      l1Weights(NNUE_L1 * 2 * NNUE_HIDDEN, 0),
+      outWeights(NNUE_L1, 0) {}
+
+void NnueNetwork::randomize(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> small(-8, 8);
+    std::uniform_int_distribution<int> medium(-32, 32);
+    for (auto &w : ftBias) w = static_cast<int16_t>(small(rng) * 4);
+    for (auto &w : ftWeights) w = static_cast<int16_t>(small(rng));
+    for (auto &w : l1Bias) w = medium(rng) * 16;
+    for (auto &w : l1Weights) w = static_cast<int8_t>(medium(rng));
+    outBias = 0;
+    for (auto &w : outWeights) w = static_cast<int8_t>(medium(rng));
+}
+
+template <class T>
+static bool readArray(std::istream& in, std::vector<T>& v) {
+    in.read(reinterpret_cast<char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+    return static_cast<bool>(in);
+}
+
+template <class T>
+static void writeArray(std::ostream& out, const std::vector<T>& v) {
+    out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+}
+
+bool NnueNetwork::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    uint32_t header[4];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != MAGIC || header[1] != VERSION ||
+        header[2] != static_cast<uint32_t>(NNUE_FEATURES) || header[3] != static_cast<uint32_t>(NNUE_HIDDEN)) {
+        return false;
+    }
+    // Read into a scratch network so a truncated file leaves this one untouched
+    NnueNetwork tmp;
+    if (!readArray(in, tmp.ftBias) || !readArray(in, tmp.ftWeights) || !readArray(in, tmp.l1Bias) ||
+        !readArray(in, tmp.l1Weights)) {
+        return false;
+    }
+    in.read(reinterpret_cast<char*>(&tmp.outBias), sizeof(tmp.outBias));
+    if (!in || !readArray(in, tmp.outWeights)) return false;
+    *this = std::move(tmp);
+    return true;
+}
+
+bool NnueNetwork::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    uint32_t header[4] = {MAGIC, VERSION, static_cast<uint32_t>(NNUE_FEATURES), static_cast<uint32_t>(NNUE_HIDDEN)};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    writeArray(out, ftBias);
+    writeArray(out, ftWeights);
+    writeArray(out, l1Bias);
+    writeArray(out, l1Weights);
+    out.write(reinterpret_cast<const char*>(&outBias), sizeof(outBias));
+    writeArray(out, outWeights);
+    return static_cast<bool>(out);
+}
+
+void NnueNetwork::refreshPerspective(const int b[8][8], int perspective, int16_t* acc) const {
+    std::copy(ftBias.begin(), ftBias.end(), acc);
+    int kingSq = findKing(b, perspective);
+    for (int sq = 0; sq < 64; ++sq) {
+        int piece = b[sq / 8][sq % 8];
+        if (piece == 0 || isKing(piece)) continue;
+        addWeights(acc, &ftWeights[static_cast<size_t>(featureIndex(perspective, kingSq, piece, sq)) * NNUE_HIDDEN]);
+    }
+}
+
+void NnueNetwork::refresh(const int b[8][8], NnueAccumulator& acc) const {
+    refreshPerspective(b, 0, acc.values[0]);
+    refreshPerspective(b, 1, acc.values[1]);
+}
+
+void NnueNetwork::update(const NnueAccumulator& prev, NnueAccumulator& next, const int b[8][8], const NnueDirty& dirty) const {
+    for (int perspective = 0; perspective < 2; ++perspective) {
+        int ownKing = perspective == 0 ? 0b0110 : 0b1110;
+        bool kingMoved = false;
+        for (int i = 0; i < dirty.count; ++i) kingMoved |= dirty.pieces[i].piece == ownKing;
+        if (kingMoved) {
+            refreshPerspective(b, perspective, next.values[perspective]);
+            continue;
+        }
+
+        int16_t* acc = next.values[perspective];
+        std::copy(prev.values[perspective], prev.values[perspective] + NNUE_HIDDEN, acc);
+        int kingSq = findKing(b, perspective);
+        for (int i = 0; i < dirty.count; ++i) {
+            const NnueDirtyPiece& d = dirty.pieces[i];
+            if (isKing(d.piece)) continue;  // kings are not features
+            if (d.from >= 0) subWeights(acc, &ftWeights[static_cast<size_t>(featureIndex(perspective, kingSq, d.piece, d.from)) * NNUE_HIDDEN]);
+            if (d.to >= 0) addWeights(acc, &ftWeights[static_cast<size_t>(featureIndex(perspective, kingSq, d.piece, d.to)) * NNUE_HIDDEN]);
+        }
+    }
+}
+
+int NnueNetwork::evaluate(const NnueAccumulator& acc, bool whiteToMove) const {
+    alignas(32) uint8_t input[2 * NNUE_HIDDEN];
+    clipToBytes(acc.values[whiteToMove ? 0 : 1], input);
+    clipToBytes(acc.values[whiteToMove ? 1 : 0], input + NNUE_HIDDEN);
+
+    int32_t out = outBias;
+    for (int o = 0; o < NNUE_L1; ++o) {
+        int32_t sum = l1Bias[o] + dotBytes(input, &l1Weights[o * 2 * NNUE_HIDDEN], 2 * NNUE_HIDDEN);
+        out += std::clamp(sum >> NNUE_L1_SHIFT, 0, 127) * outWeights[o];
+    }
+    return out / NNUE_OUTPUT_SCALE;
+}
+
+int NnueNetwork::evaluateScalar(const NnueAccumulator& acc, bool whiteToMove) const {
+    uint8_t input[2 * NNUE_HIDDEN];
+    const int16_t* us = acc.values[whiteToMove ? 0 : 1];
+    const int16_t* them = acc.values[whiteToMove ? 1 : 0];
+    for (int i = 0; i < NNUE_HIDDEN; ++i) {
+        input[i] = static_cast<uint8_t>(std::clamp<int>(us[i], 0, 127));
+        input[NNUE_HIDDEN + i] = static_cast<uint8_t>(std::clamp<int>(them[i], 0, 127));
+    }
+
+    int32_t out = outBias;
+    for (int o = 0; o < NNUE_L1; ++o) {
+        int32_t sum = l1Bias[o];
+        for (int i = 0; i < 2 * NNUE_HIDDEN; ++i) sum += static_cast<int32_t>(input[i]) * l1Weights[o * 2 * NNUE_HIDDEN + i];
+        out += std::clamp(sum >> NNUE_L1_SHIFT, 0, 127) * outWeights[o];
+    }
+    return out / NNUE_OUTPUT_SCALE;
+}
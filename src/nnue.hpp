@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// NNUE ("efficiently updatable neural network") evaluation.
+//
+// Architecture (HalfKP):
+//   features   40960 per perspective = own king square (64) x non-king piece
+//              (5 types x 2 colours relative to the perspective) x square (64)
+//   transform  40960 -> NNUE_HIDDEN int16, one accumulator per perspective,
+//              updated incrementally as pieces move
+//   layer 1    [side to move, other side] clipped to 0..127 (uint8) -> 32, int8 weights
+//   output     32 clipped activations -> 1, int8 weights
+// The output divided by NNUE_OUTPUT_SCALE is the score in centipawns from the
+// side to move's point of view.
+//
+// Squares are row*8+col on the engine's board (row 0 = rank 8); features use
+// a1 = 0 from white's view and the vertically mirrored square from black's.
+
+constexpr int NNUE_FEATURES = 64 * 10 * 64;
+constexpr int NNUE_HIDDEN = 256;
+constexpr int NNUE_L1 = 32;
+constexpr int NNUE_L1_SHIFT = 6;       // layer-1 sums are scaled down by 2^6 before clipping
+constexpr int NNUE_OUTPUT_SCALE = 16;  // output units per centipawn
+
+// Accumulated feature-transformer output for both perspectives (0 = white, 1 = black)
+struct alignas(32) NnueAccumulator {
+    int16_t values[2][NNUE_HIDDEN];
+};
+
+// Pieces changed by one move. A square of -1 means "not on the board"
+// (captured piece: to = -1; promotion: pawn to = -1, new piece from = -1).
+struct NnueDirtyPiece {
+    int piece;
+    int from;
+    int to;
+};
+
+struct NnueDirty {
+    int count = 0;
+    NnueDirtyPiece pieces[3];
+    void add(int piece, int from, int to) { pieces[count++] = {piece, from, to}; }
+};
+
+class NnueNetwork {
+public:
+    NnueNetwork();
+
+    // Weight file layout (little endian): uint32 magic "CNNU", uint32 version,
+    // uint32 features, uint32 hidden, then ftBias, ftWeights, l1Bias,
+    // l1Weights, outBias, outWeights in the order and types declared below.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    // Small random weights (for tests and as a starting point for training)
+    void randomize(uint32_t seed);
+
+    // Rebuild both perspectives from a board
+    void refresh(const int b[8][8], NnueAccumulator& acc) const;
+    // next = prev + the move's changes; 'b' is the board after the move.
+    // A perspective whose king moved is rebuilt from scratch.
+    void update(const NnueAccumulator& prev, NnueAccumulator& next, const int b[8][8], const NnueDirty& dirty) const;
+
+    // Centipawns for the side to move (SIMD kernels where available)
+    int evaluate(const NnueAccumulator& acc, bool whiteToMove) const;
+    // Plain C++ reference of evaluate(), used to check the SIMD kernels
+    int evaluateScalar(const NnueAccumulator& acc, bool whiteToMove) const;
+
+    // Kernel set compiled into this build: "avx2", "ssse3" or "scalar"
+    static const char* simdName();
+
+private:
+    static constexpr uint32_t MAGIC = 0x554E4E43;  // "CNNU"
+    static constexpr uint32_t VERSION = 1;
+
+    std::vector<int16_t> ftBias;     // [NNUE_HIDDEN]
+    std::vector<int16_t> ftWeights;  // [NNUE_FEATURES][NNUE_HIDDEN]
+    std::vector<int32_t> l1Bias;     // [NNUE_L1]
+    std::vector<int8_t> l1Weights;   // [NNUE_L1][2 * NNUE_HIDDEN]
+    int32_t outBias = 0;
+    std::vector<int8_t> outWeights;  // [NNUE_L1]
+
+    void refreshPerspective(const int b[8][8], int perspective, int16_t* acc) const;
+};
@@ -0,0 +1,26 @@
+#include "positionBatch.hpp"
+
+PackedPosition PackedPosition::fromBoard(const int b[8][8], bool whiteToMove) {
+    PackedPosition p;
+    for (int sq = 0; sq < 64; ++sq) {
+        p.squares[sq >> 1] |= static_cast<uint8_t>((b[sq / 8][sq % 8] & 0xF) << ((sq & 1) * 4));
+    }
+    p.whiteToMove = whiteToMove ? 1 : 0;
+    return p;
+}
+
+void PackedPosition::toBoard(int b[8][8]) const {
+    for (int sq = 0; sq < 64; ++sq) b[sq / 8][sq % 8] = piece(sq);
+}
+
+PositionBatch::PositionBatch(const std::vector<PackedPosition>& positions)
+    : count(positions.size()), codes(64 * positions.size()), sideToMove(positions.size()) {
+    for (size_t i = 0; i < count; ++i) {
+        for (int sq = 0; sq < 64; ++sq) codes[static_cast<size_t>(sq) * count + i] = static_cast<uint8_t>(positions[i].piece(sq));
+        sideToMove[i] = positions[i].whiteToMove;
+    }
+}
+
+void PositionBatch::toBoard(size_t i, int b[8][8]) const {
+    for (int sq = 0; sq < 64; ++sq) b[sq / 8][sq % 8] = codes[static_cast<size_t>(sq) * count + i];
+}
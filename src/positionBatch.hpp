@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compact position encoding for bulk evaluation: one nibble per square
+// holding the board's piece code (bit 3 = black), square = row * 8 + col.
+// 33 bytes per position instead of a ChessGame.
+struct PackedPosition {
+    uint8_t squares[32] = {};  // square 2k in the low nibble, 2k + 1 in the high nibble
+    uint8_t whiteToMove = 1;
+
+    static PackedPosition fromBoard(const int b[8][8], bool whiteToMove);
+    int piece(int square) const { return (squares[square >> 1] >> ((square & 1) * 4)) & 0xF; }
+    void toBoard(int b[8][8]) const;
+};
+
+// Structure-of-arrays copy of many positions: the piece codes on one square
+// for all positions are contiguous, so per-square table lookups in
+// Evaluation::evaluateBatch run over consecutive bytes.
+class PositionBatch {
+public:
+    PositionBatch() = default;
+    explicit PositionBatch(const std::vector<PackedPosition>& positions);
+
+    size_t size() const { return count; }
+    // Piece codes on 'square' for positions 0..size()-1
+    const uint8_t* square(int square) const { return codes.data() + static_cast<size_t>(square) * count; }
+    bool whiteToMove(size_t i) const { return sideToMove[i] != 0; }
+    void toBoard(size_t i, int b[8][8]) const;
+
+private:
+    size_t count = 0;
+    std::vector<uint8_t> codes;       // [64][count]
+    std::vector<uint8_t> sideToMove;  // [count]
+};
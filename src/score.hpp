@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+// Middlegame/endgame score pair packed into one 32-bit integer: the
+// endgame value in the upper 16 bits, the middlegame value in the lower 16.
+// Adding or subtracting two Scores adds both halves at once, so summing
+// piece-square terms costs one add per piece for both phases.
+using Score = int32_t;
+
+constexpr Score makeScore(int mg, int eg) {
+    return static_cast<Score>(static_cast<uint32_t>(eg) << 16) + mg;
+}
+
+// The +0x8000 undoes the borrow a negative middlegame half takes from the endgame half
+inline int egValue(Score s) {
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(s + 0x8000) >> 16));
+}
+
+inline int mgValue(Score s) {
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(s)));
+}
+
+// Game phase from non-pawn material: knight/bishop 1, rook 2, queen 4;
+// 24 = all pieces on the board (pure middlegame), 0 = pawns and kings only
+constexpr int PHASE_MAX = 24;
+
+// Interpolate between the halves; phase is clamped to PHASE_MAX (promotions)
+inline int taper(Score s, int phase) {
+    if (phase > PHASE_MAX) phase = PHASE_MAX;
+    return (mgValue(s) * phase + egValue(s) * (PHASE_MAX - phase)) / PHASE_MAX;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+// Per-iteration search statistics for tuning move ordering and pruning.
+// The engine only records into a collector when built with ENGINE_SEARCH_STATS
+// (CMake option of the same name) and one is attached with
+// Engine::setSearchStats; otherwise the hooks compile to nothing.
+struct DepthStats {
+    uint64_t nodes = 0;             // alphabeta nodes
+    uint64_t qnodes = 0;            // quiescence nodes
+    uint64_t nonPvNodes = 0;        // alphabeta nodes searched with a zero window
+    uint64_t cutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;  // cutoffs by the first move tried
+    uint64_t ttMoveNodes = 0;       // nodes with a legal TT move
+    uint64_t ttMoveCutoffs = 0;     // ... where the TT move caused the cutoff
+    uint64_t nullMoveTries = 0;
+    uint64_t nullMoveCutoffs = 0;
+    uint64_t lmrSearches = 0;       // reduced searches
+    uint64_t lmrResearches = 0;     // ... that had to be repeated at full depth
+    long long timeMs = 0;           // time to complete this iteration
+    bool completed = false;
+};
+
+struct SearchStats {
+    static constexpr int MAX_DEPTH = 64;
+    std::array<DepthStats, MAX_DEPTH + 1> depths{};
+
+    void reset() { depths.fill(DepthStats()); }
+
+    DepthStats& at(int depth) { return depths[depth < 0 ? 0 : (depth > MAX_DEPTH ? MAX_DEPTH : depth)]; }
+
+    // One object per completed iteration. Rates are fractions (0..1);
+    // "ebf" is the total node ratio to the previous iteration.
+    std::string toJson() const {
+        std::ostringstream out;
+        out << "{\"iterations\":[";
+        bool first = true;
+        uint64_t prevTotal = 0;
+        for (int d = 1; d <= MAX_DEPTH; ++d) {
+            const DepthStats& s = depths[d];
+            if (!s.completed) continue;
+            uint64_t total = s.nodes + s.qnodes;
+            out << (first ? "" : ",")
+                << "{\"depth\":" << d
+                << ",\"nodes\":" << s.nodes
+                << ",\"qnodes\":" << s.qnodes
+                << ",\"time_ms\":" << s.timeMs
+                << ",\"non_pv_node_rate\":" << rate(s.nonPvNodes, s.nodes)
+                << ",\"first_move_cutoff_rate\":" << rate(s.firstMoveCutoffs, s.cutoffs)
+                << ",\"tt_move_cutoff_rate\":" << rate(s.ttMoveCutoffs, s.ttMoveNodes)
+                << ",\"null_move_success_rate\":" << rate(s.nullMoveCutoffs, s.nullMoveTries)
+                << ",\"lmr_research_rate\":" << rate(s.lmrResearches, s.lmrSearches)
+                << ",\"ebf\":" << rate(total, prevTotal)
+                << "}";
+            first = false;
+            prevTotal = total;
+        }
+        out << "]}";
+        return out.str();
+    }
+
+private:
+    static double rate(uint64_t num, uint64_t den) { return den ? static_cast<double>(num) / den : 0.0; }
+};
@@ -0,0 +1,1042 @@
+#include "tablebase.hpp"
+#include "board.hpp"
+#include "game.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Pieces and signatures
+
+static const char PIECE_LETTERS[] = " PRNBQK";
+// Signature order within a side, strongest first
+static const int SIGNATURE_ORDER[] = {5, 2, 4, 3, 1};  // Q R B N P
+static const int SIGNATURE_VALUE[] = {0, 1, 5, 3, 3, 9, 0};
+
+static bool isWhitePiece(int piece) { return !(piece & 0b1000); }
+static int pieceType(int piece) { return piece & 0b0111; }
+
+static int orderOf(int type) {
+    for (int i = 0; i < 5; i++) {
+        if (SIGNATURE_ORDER[i] == type) return i;
+    }
+    return 5;
+}
+
+static int typeOfLetter(char c) {
+    const char* p = std::strchr(PIECE_LETTERS + 1, c);
+    return (c && p) ? static_cast<int>(p - PIECE_LETTERS) : 0;
+}
+
+// Positive if side 'a' (non-king piece types) is the stronger one
+static int compareSides(const std::vector<int>& a, const std::vector<int>& b) {
+    int valueA = 0, valueB = 0;
+    for (int t : a) valueA += SIGNATURE_VALUE[t];
+    for (int t : b) valueB += SIGNATURE_VALUE[t];
+    if (valueA != valueB) return valueA - valueB;
+    if (a.size() != b.size()) return static_cast<int>(a.size()) - static_cast<int>(b.size());
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i] != b[i]) return orderOf(b[i]) - orderOf(a[i]);
+    }
+    return 0;
+}
+
+static void sortSide(std::vector<int>& side) {
+    std::sort(side.begin(), side.end(), [](int a, int b) { return orderOf(a) < orderOf(b); });
+}
+
+static std::string sideName(const std::vector<int>& side) {
+    std::string name = "K";
+    for (int t : side) name += PIECE_LETTERS[t];
+    return name;
+}
+
+// "KQKR" -> {Q}, {R}; false if malformed
+static bool parseSignature(const std::string& signature, std::vector<int>& white, std::vector<int>& black) {
+    white.clear();
+    black.clear();
+    if (signature.size() < 2 || signature[0] != 'K') return false;
+    size_t second = signature.find('K', 1);
+    if (second == std::string::npos) return false;
+    for (size_t i = 1; i < signature.size(); i++) {
+        if (i == second) continue;
+        int type = typeOfLetter(signature[i]);
+        if (type == 0 || type == 6) return false;
+        (i < second ? white : black).push_back(type);
+    }
+    if (white.size() + black.size() + 2 > TB_MAX_PIECES) return false;
+    sortSide(white);
+    sortSide(black);
+    return true;
+}
+
+std::string canonicalSignature(const std::string& signature) {
+    std::vector<int> white, black;
+    if (!parseSignature(signature, white, black)) return "";
+    if (compareSides(white, black) < 0) std::swap(white, black);
+    return sideName(white) + sideName(black);
+}
+
+std::vector<std::string> allSignatures(int maxPieces) {
+    // Multisets of non-king pieces as sorted type lists
+    std::vector<std::vector<int>> sides(1);
+    for (size_t i = 0; i < sides.size(); i++) {
+        if (static_cast<int>(sides[i].size()) + 2 >= maxPieces) continue;
+        int last = sides[i].empty() ? 0 : orderOf(sides[i].back());
+        for (int o = last; o < 5; o++) {
+            std::vector<int> more = sides[i];
+            more.push_back(SIGNATURE_ORDER[o]);
+            sides.push_back(more);
+        }
+    }
+    std::vector<std::string> result;
+    for (int pieces = 3; pieces <= std::min(maxPieces, TB_MAX_PIECES); pieces++) {
+        for (const auto& white : sides) {
+            for (const auto& black : sides) {
+                if (static_cast<int>(white.size() + black.size()) + 2 != pieces) continue;
+                if (compareSides(white, black) < 0) continue;
+                std::string name = sideName(white) + sideName(black);
+                if (std::find(result.begin(), result.end(), name) == result.end()) result.push_back(name);
+            }
+        }
+    }
+    return result;
+}
+
+static MaterialKey positionMaterialKey(const TablebasePosition& pos) {
+    MaterialKey key = 0;
+    for (int i = 0; i < pos.count; i++) key += materialKeyOf(pos.piece[i]);
+    return key;
+}
+
+// ---------------------------------------------------------------------------
+// Indexing. Pawnless tables use the eight board symmetries to bring the
+// white king into the a1-d1-d4 triangle (and the black king on or below the
+// a1-h8 diagonal when the white king is on it): 462 king pairs. Tables with
+// pawns can only be mirrored left-right: white king on files a-d, pawns on
+// 48 squares. Every other piece gets 64 squares. A position's index is the
+// smallest over its symmetric images, identical pieces sorted.
+
+static int transformSquare(int sq, int t) {
+    int rank = sq / 8, file = sq % 8;
+    if (t & 4) std::swap(rank, file);
+    if (t & 1) file = 7 - file;
+    if (t & 2) rank = 7 - rank;
+    return rank * 8 + file;
+}
+
+static int kingDistance(int a, int b) { return std::max(std::abs(a / 8 - b / 8), std::abs(a % 8 - b % 8)); }
+
+struct KingPairs {
+    int index[64][64];
+    std::vector<std::pair<int, int>> pairs;
+    uint8_t square[8][64];      // transformSquare, tabulated
+    int transforms[64][2];      // those taking a white king square to an allowed one
+    int transformCount[64];
+
+    explicit KingPairs(bool pawns) {
+        for (int t = 0; t < 8; t++) {
+            for (int sq = 0; sq < 64; sq++) square[t][sq] = static_cast<uint8_t>(transformSquare(sq, t));
+        }
+        for (int wk = 0; wk < 64; wk++) {
+            for (int bk = 0; bk < 64; bk++) {
+                int rank = wk / 8, file = wk % 8;
+                bool ok = kingDistance(wk, bk) > 1;
+                if (pawns) {
+                    ok = ok && file < 4;
+                } else {
+                    ok = ok && file < 4 && rank <= file;
+                    if (rank == file) ok = ok && bk / 8 <= bk % 8;
+                }
+                index[wk][bk] = ok ? static_cast<int>(pairs.size()) : -1;
+                if (ok) pairs.emplace_back(wk, bk);
+            }
+        }
+        for (int wk = 0; wk < 64; wk++) {
+            transformCount[wk] = 0;
+            for (int t = 0; t < (pawns ? 2 : 8); t++) {
+                int to = square[t][wk];
+                bool allowed = pawns ? to % 8 < 4 : (to % 8 < 4 && to / 8 <= to % 8);
+                if (allowed && transformCount[wk] < 2) transforms[wk][transformCount[wk]++] = t;
+            }
+        }
+    }
+};
+
+static const KingPairs& kingPairs(bool pawns) {
+    static const KingPairs pawnless(false), withPawns(true);
+    return pawns ? withPawns : pawnless;
+}
+
+// ---------------------------------------------------------------------------
+// Table files
+
+namespace {
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t pieceCount;
+    uint32_t entriesPerSide;
+    char signature[16];
+};
+static_assert(sizeof(FileHeader) == 32, "table header layout");
+constexpr char TB_MAGIC[4] = {'C', 'T', 'B', '1'};
+constexpr uint32_t TB_VERSION = 1;
+constexpr uint8_t TB_ILLEGAL = 128;
+}
+
+class TablebaseFile {
+public:
+    std::string signature;
+    MaterialKey key = 0;
+    int count = 0;
+    int piece[TB_MAX_PIECES];  // slot order: white king, black king, white pieces, black pieces
+    bool pawns = false;
+    uint32_t perSide = 0;
+
+    explicit TablebaseFile(const std::string& sig) : signature(sig) {
+        std::vector<int> white, black;
+        parseSignature(sig, white, black);
+        piece[count++] = WHITE_KING;
+        piece[count++] = BLACK_KING;
+        for (int t : white) piece[count++] = t;
+        for (int t : black) piece[count++] = t | 0b1000;
+        for (int i = 2; i < count; i++) pawns |= pieceType(piece[i]) == 1;
+        uint64_t size = kingPairs(pawns).pairs.size();
+        for (int i = 2; i < count; i++) size *= squareRange(i);
+        perSide = static_cast<uint32_t>(size);
+        for (int i = 0; i < count; i++) key += materialKeyOf(piece[i]);
+    }
+
+    ~TablebaseFile() { unmap(); }
+
+    uint32_t entries() const { return 2 * perSide; }
+    int squareRange(int slot) const { return pieceType(piece[slot]) == 1 ? 48 : 64; }
+
+    // Index of a position whose pieces are in slot order, -1 if the kings
+    // touch or a pawn stands on the first or last rank
+    int64_t index(const TablebasePosition& pos) const {
+        const KingPairs& kings = kingPairs(pawns);
+        int64_t best = -1;
+        for (int k = 0; k < kings.transformCount[pos.square[0]]; k++) {
+            const uint8_t* map = kings.square[kings.transforms[pos.square[0]][k]];
+            int kk = kings.index[map[pos.square[0]]][map[pos.square[1]]];
+            if (kk < 0) continue;
+            int sq[TB_MAX_PIECES];
+            for (int i = 2; i < count; i++) sq[i] = map[pos.square[i]];
+            for (int i = 2; i < count;) {
+                int j = i + 1;
+                while (j < count && piece[j] == piece[i]) j++;
+                std::sort(sq + i, sq + j);
+                i = j;
+            }
+            int64_t idx = kk;
+            for (int i = 2; i < count; i++) {
+                int s = sq[i];
+                if (squareRange(i) == 48) {
+                    if (s < 8 || s >= 56) return -1;
+                    s -= 8;
+                }
+                idx = idx * squareRange(i) + s;
+            }
+            if (best < 0 || idx < best) best = idx;
+        }
+        if (best < 0) return -1;
+        return (pos.whiteToMove ? 0 : int64_t(perSide)) + best;
+    }
+
+    void decode(uint32_t idx, TablebasePosition& pos) const {
+        pos.count = count;
+        pos.whiteToMove = idx < perSide;
+        uint32_t rest = pos.whiteToMove ? idx : idx - perSide;
+        for (int i = count - 1; i >= 2; i--) {
+            int range = squareRange(i);
+            int s = static_cast<int>(rest % range);
+            rest /= range;
+            pos.square[i] = range == 48 ? s + 8 : s;
+            pos.piece[i] = piece[i];
+        }
+        const auto& kk = kingPairs(pawns).pairs[rest];
+        pos.square[0] = kk.first;
+        pos.square[1] = kk.second;
+        pos.piece[0] = WHITE_KING;
+        pos.piece[1] = BLACK_KING;
+    }
+
+    uint8_t at(int64_t idx) const { return data[idx]; }
+
+    bool map(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) { CloseHandle(file); return false; }
+        mappedSize = static_cast<size_t>(size.QuadPart);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return false;
+        base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!base) { CloseHandle(mapping); mapping = nullptr; return false; }
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+        mappedSize = static_cast<size_t>(st.st_size);
+        void* p = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        base = p;
+#endif
+        FileHeader header;
+        if (mappedSize < sizeof(header)) { unmap(); return false; }
+        std::memcpy(&header, base, sizeof(header));
+        if (std::memcmp(header.magic, TB_MAGIC, 4) != 0 || header.version != TB_VERSION ||
+            header.pieceCount != static_cast<uint32_t>(count) || header.entriesPerSide != perSide ||
+            std::strncmp(header.signature, signature.c_str(), sizeof(header.signature)) != 0 ||
+            mappedSize != sizeof(header) + size_t(entries())) {
+            unmap();
+            return false;
+        }
+        data = static_cast<const uint8_t*>(base) + sizeof(header);
+        return true;
+    }
+
+private:
+    const uint8_t* data = nullptr;
+    void* base = nullptr;
+    size_t mappedSize = 0;
+#ifdef _WIN32
+    HANDLE mapping = nullptr;
+#endif
+
+    void unmap() {
+        if (!base) return;
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(mapping);
+        mapping = nullptr;
+#else
+        munmap(base, mappedSize);
+#endif
+        base = nullptr;
+        data = nullptr;
+    }
+};
+
+static bool writeTableFile(const std::string& path, const TablebaseFile& table, const std::vector<uint8_t>& entries) {
+    FileHeader header{};
+    std::memcpy(header.magic, TB_MAGIC, 4);
+    header.version = TB_VERSION;
+    header.pieceCount = static_cast<uint32_t>(table.count);
+    header.entriesPerSide = table.perSide;
+    std::strncpy(header.signature, table.signature.c_str(), sizeof(header.signature) - 1);
+
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size()));
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    return !ec;
+}
+
+// ---------------------------------------------------------------------------
+// Probing
+
+static TablebaseValue valueFromByte(uint8_t byte) {
+    TablebaseValue v;
+    if (byte == 0) return v;
+    if (byte < TB_ILLEGAL) {
+        v.wdl = 1;
+        v.plies = 2 * byte - 1;
+    } else {
+        v.wdl = -1;
+        v.plies = 2 * (byte - TB_ILLEGAL - 1);
+    }
+    return v;
+}
+
+Tablebase::Tablebase() = default;
+Tablebase::~Tablebase() = default;
+
+void Tablebase::clear() {
+    byMaterial.clear();
+    files.clear();
+    largest = 0;
+}
+
+bool Tablebase::hasTable(const std::string& signature) const {
+    for (const auto& file : files) {
+        if (file->signature == signature) return true;
+    }
+    return false;
+}
+
+bool Tablebase::loadFile(const std::string& path) {
+    std::string name = fs::path(path).stem().string();
+    std::string sig = canonicalSignature(name);
+    if (sig.empty() || sig != name) return false;
+    if (hasTable(sig)) return true;
+    auto file = std::make_unique<TablebaseFile>(sig);
+    if (!file->map(path)) return false;
+
+    // The same table answers for the colour-reversed material
+    MaterialKey flippedKey = 0;
+    for (int i = 0; i < file->count; i++) flippedKey += materialKeyOf(file->piece[i] ^ 0b1000);
+    byMaterial[file->key] = Entry{file.get(), false};
+    if (flippedKey != file->key) byMaterial[flippedKey] = Entry{file.get(), true};
+    largest = std::max(largest, file->count);
+    files.push_back(std::move(file));
+    return true;
+}
+
+int Tablebase::load(const std::string& dir) {
+    std::error_code ec;
+    fs::directory_iterator it(dir, ec);
+    if (ec) return -1;
+    int loaded = 0;
+    for (const auto& entry : it) {
+        if (entry.path().extension() != ".ctb") continue;
+        size_t before = files.size();
+        if (loadFile(entry.path().string()) && files.size() > before) loaded++;
+    }
+    return loaded;
+}
+
+bool Tablebase::probe(const TablebasePosition& pos, TablebaseValue& value) const {
+    if (pos.count == 2) {
+        value = TablebaseValue();
+        return true;
+    }
+    auto found = byMaterial.find(positionMaterialKey(pos));
+    if (found == byMaterial.end()) return false;
+    const TablebaseFile& file = *found->second.file;
+    const bool flipped = found->second.flipped;
+
+    // Put the pieces into the file's slot order, colours swapped if needed
+    TablebasePosition oriented;
+    oriented.count = file.count;
+    oriented.whiteToMove = pos.whiteToMove != flipped;
+    bool used[TB_MAX_PIECES] = {};
+    for (int slot = 0; slot < file.count; slot++) {
+        for (int i = 0; i < pos.count; i++) {
+            int piece = flipped ? (pos.piece[i] ^ 0b1000) : pos.piece[i];
+            if (used[i] || piece != file.piece[slot]) continue;
+            used[i] = true;
+            oriented.piece[slot] = piece;
+            oriented.square[slot] = flipped ? (pos.square[i] ^ 56) : pos.square[i];
+            break;
+        }
+    }
+    int64_t idx = file.index(oriented);
+    if (idx < 0) return false;
+    uint8_t byte = file.at(idx);
+    if (byte == TB_ILLEGAL) return false;
+    value = valueFromByte(byte);
+    return true;
+}
+
+// Castling is only possible with king and rook on their home squares
+static bool castlingRightsLeft() {
+    bool white = !whiteKingMoved && board[7][4] == WHITE_KING &&
+                 ((!whiteKingsideRookMoved && board[7][7] == WHITE_ROOK) ||
+                  (!whiteQueensideRookMoved && board[7][0] == WHITE_ROOK));
+    bool black = !blackKingMoved && board[0][4] == BLACK_KING &&
+                 ((!blackKingsideRookMoved && board[0][7] == BLACK_ROOK) ||
+                  (!blackQueensideRookMoved && board[0][0] == BLACK_ROOK));
+    return white || black;
+}
+
+// A pawn of the side to move can take en passant
+static bool enPassantPossible(bool whiteToMove) {
+    if (enPassantTargetRow < 0) return false;
+    int row = enPassantTargetRow + (whiteToMove ? 1 : -1);
+    int pawn = whiteToMove ? WHITE_PAWN : BLACK_PAWN;
+    if (row < 0 || row > 7) return false;
+    for (int col = enPassantTargetCol - 1; col <= enPassantTargetCol + 1; col += 2) {
+        if (col >= 0 && col < 8 && board[row][col] == pawn) return true;
+    }
+    return false;
+}
+
+bool Tablebase::probe(const ChessGame& game, TablebaseValue& value) const {
+    MaterialKey key = game.getMaterialKey();
+    if (files.empty()) return false;
+    if (key == materialKeyOf(WHITE_KING) + materialKeyOf(BLACK_KING)) {
+        value = TablebaseValue();
+        return true;
+    }
+    if (byMaterial.find(key) == byMaterial.end()) return false;
+    if (castlingRightsLeft() || enPassantPossible(game.isWhiteToMove())) return false;
+    TablebasePosition pos;
+    pos.whiteToMove = game.isWhiteToMove();
+    for (int row = 0; row < 8; row++) {
+        for (int col = 0; col < 8; col++) {
+            if (board[row][col] == EMPTY) continue;
+            if (pos.count == TB_MAX_PIECES) return false;
+            pos.piece[pos.count] = board[row][col];
+            pos.square[pos.count++] = (7 - row) * 8 + col;
+        }
+    }
+    return probe(pos, value);
+}
+
+// ---------------------------------------------------------------------------
+// Move generation for the generator (squares as in TablebasePosition)
+
+static const int KING_STEPS[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+static const int KNIGHT_STEPS[8][2] = {{1, 2}, {2, 1}, {-1, 2}, {-2, 1}, {1, -2}, {2, -1}, {-1, -2}, {-2, -1}};
+
+static bool onBoard(int rank, int file) { return rank >= 0 && rank < 8 && file >= 0 && file < 8; }
+
+// Does 'piece' on 'from' attack 'to'? occ[sq] is non-zero where a piece stands
+static bool attacks(int piece, int from, int to, const int occ[64]) {
+    int dr = to / 8 - from / 8, df = to % 8 - from % 8;
+    switch (pieceType(piece)) {
+    case 1:
+        return std::abs(df) == 1 && dr == (isWhitePiece(piece) ? 1 : -1);
+    case 3:
+        return (std::abs(dr) == 1 && std::abs(df) == 2) || (std::abs(dr) == 2 && std::abs(df) == 1);
+    case 6:
+        return std::max(std::abs(dr), std::abs(df)) == 1;
+    default:
+        break;
+    }
+    bool straight = dr == 0 || df == 0;
+    bool diagonal = std::abs(dr) == std::abs(df);
+    int type = pieceType(piece);
+    if (from == to || !((straight && (type == 2 || type == 5)) || (diagonal && (type == 4 || type == 5)))) return false;
+    int stepR = (dr > 0) - (dr < 0), stepF = (df > 0) - (df < 0);
+    for (int sq = from + stepR * 8 + stepF; sq != to; sq += stepR * 8 + stepF) {
+        if (occ[sq]) return false;
+    }
+    return true;
+}
+
+static void fillOccupancy(const TablebasePosition& pos, int occ[64]) {
+    std::fill(occ, occ + 64, 0);
+    for (int i = 0; i < pos.count; i++) occ[pos.square[i]] = i + 1;
+}
+
+// Is the king of colour 'white' attacked?
+static bool kingAttacked(const TablebasePosition& pos, const int occ[64], bool white) {
+    int king = -1;
+    for (int i = 0; i < pos.count; i++) {
+        if (pos.piece[i] == (white ? WHITE_KING : BLACK_KING)) king = pos.square[i];
+    }
+    for (int i = 0; i < pos.count; i++) {
+        if (isWhitePiece(pos.piece[i]) != white && attacks(pos.piece[i], pos.square[i], king, occ)) return true;
+    }
+    return false;
+}
+
+struct GenMove {
+    int slot, to;
+    int captured;   // slot, -1 if none
+    int promotion;  // piece code, 0 if none
+    bool doublePush;
+};
+
+// Pseudo-legal moves of the side to move
+static int generateMoves(const TablebasePosition& pos, const int occ[64], GenMove* moves) {
+    int n = 0;
+    const bool white = pos.whiteToMove;
+    for (int i = 0; i < pos.count; i++) {
+        int piece = pos.piece[i];
+        if (isWhitePiece(piece) != white) continue;
+        int from = pos.square[i], rank = from / 8, file = from % 8;
+        auto add = [&](int to, bool doublePush = false) {
+            int target = occ[to] - 1;
+            if (target >= 0 && (isWhitePiece(pos.piece[target]) == white || pieceType(pos.piece[target]) == 6)) return;
+            int lastRank = white ? 7 : 0;
+            if (pieceType(piece) == 1 && to / 8 == lastRank) {
+                for (int type : {5, 2, 4, 3}) moves[n++] = GenMove{i, to, target, white ? type : (type | 0b1000), false};
+            } else {
+                moves[n++] = GenMove{i, to, target, 0, doublePush};
+            }
+        };
+        switch (pieceType(piece)) {
+        case 1: {
+            int dir = white ? 1 : -1;
+            int push = from + 8 * dir;
+            if (!occ[push]) {
+                add(push);
+                int startRank = white ? 1 : 6;
+                if (rank == startRank && !occ[push + 8 * dir]) add(push + 8 * dir, true);
+            }
+            for (int df : {-1, 1}) {
+                if (file + df < 0 || file + df > 7) continue;
+                int to = push + df;
+                if (occ[to] && isWhitePiece(pos.piece[occ[to] - 1]) != white) add(to);
+            }
+            break;
+        }
+        case 3:
+        case 6: {
+            const int (*steps)[2] = pieceType(piece) == 3 ? KNIGHT_STEPS : KING_STEPS;
+            for (int d = 0; d < 8; d++) {
+                int r = rank + steps[d][0], f = file + steps[d][1];
+                if (onBoard(r, f)) add(r * 8 + f);
+            }
+            break;
+        }
+        default: {
+            int type = pieceType(piece);
+            for (int d = (type == 4 ? 4 : 0); d < (type == 2 ? 4 : 8); d++) {
+                for (int r = rank + KING_STEPS[d][0], f = file + KING_STEPS[d][1]; onBoard(r, f);
+                     r += KING_STEPS[d][0], f += KING_STEPS[d][1]) {
+                    add(r * 8 + f);
+                    if (occ[r * 8 + f]) break;
+                }
+            }
+            break;
+        }
+        }
+    }
+    return n;
+}
+
+// Position after 'move'; a captured piece is removed (slots after it move down)
+static TablebasePosition applyMove(const TablebasePosition& pos, const GenMove& move) {
+    TablebasePosition child = pos;
+    child.square[move.slot] = move.to;
+    if (move.promotion) child.piece[move.slot] = move.promotion;
+    if (move.captured >= 0) {
+        for (int i = move.captured; i + 1 < child.count; i++) {
+            child.square[i] = child.square[i + 1];
+            child.piece[i] = child.piece[i + 1];
+        }
+        child.count--;
+    }
+    child.whiteToMove = !pos.whiteToMove;
+    return child;
+}
+
+// ---------------------------------------------------------------------------
+// Generator. Working values: 0 unknown, 1 illegal, 2 draw, 3 + d decided
+// with mate d plies away (d odd: the side to move mates, even: is mated).
+//
+// Retrograde analysis by distance: the positions decided at d plies are
+// un-moved to find their predecessors, which are then re-examined with
+// every move generated forwards. A predecessor is decided at d + 1 once it
+// has a move into a loss, or all its moves lead to wins for the opponent.
+// Captures and promotions leave the table and are answered by the smaller
+// tables; when one of them settles a position at a later distance it is
+// queued for re-examination then. Whatever is never decided is a draw.
+
+namespace {
+constexpr uint16_t WORK_UNKNOWN = 0, WORK_ILLEGAL = 1, WORK_DRAW = 2, WORK_DECIDED = 3;
+
+struct Outcome {
+    bool known = false;
+    TablebaseValue value;  // for the side to move in the child
+};
+
+// Preference of the side to move: quicker wins, then draws, then slower losses
+int preference(const TablebaseValue& v) {
+    return v.wdl > 0 ? 100000 - v.plies : (v.wdl < 0 ? -100000 + v.plies : 0);
+}
+
+TablebaseValue fromWork(uint16_t w) {
+    TablebaseValue v;
+    if (w >= WORK_DECIDED) {
+        v.plies = w - WORK_DECIDED;
+        v.wdl = (v.plies % 2) ? 1 : -1;
+    }
+    return v;
+}
+
+uint16_t toWork(const TablebaseValue& v) {
+    return v.wdl == 0 ? WORK_DRAW : static_cast<uint16_t>(WORK_DECIDED + v.plies);
+}
+
+class Generator {
+public:
+    Generator(const TablebaseFile& table, const Tablebase& smaller) : table(table), smaller(smaller) {}
+
+    bool run(std::vector<uint8_t>& out, std::ostream* log) {
+        const uint32_t entries = table.entries();
+        work.assign(entries, WORK_UNKNOWN);
+        unresolved.assign(entries, 0);
+        pending.clear();
+        std::vector<uint32_t> frontier;
+
+        for (uint32_t idx = 0; idx < entries; idx++) {
+            TablebasePosition pos;
+            table.decode(idx, pos);
+            if (!isLegal(pos, idx)) {
+                work[idx] = WORK_ILLEGAL;
+                continue;
+            }
+            visit(idx, 0, frontier);
+        }
+        if (missingTable) return false;
+
+        int level = 0;
+        for (; !frontier.empty() || level + 1 < static_cast<int>(pending.size()); level++) {
+            std::vector<uint32_t> next;
+            for (uint32_t idx : frontier) {
+                TablebasePosition pos;
+                table.decode(idx, pos);
+                // A move into a loss wins at once (unless en passant may
+                // spoil it); a move into a win only matters if every
+                // other move loses as well
+                const bool lost = (work[idx] - WORK_DECIDED) % 2 == 0;
+                forEachPredecessor(pos, [&](uint32_t pred, bool doublePush) {
+                    if (work[pred] != WORK_UNKNOWN) return;
+                    if (lost && !doublePush) {
+                        work[pred] = toWork(TablebaseValue{1, level + 1});
+                        next.push_back(pred);
+                        return;
+                    }
+                    bool exhausted = unresolved[pred] <= 1;
+                    unresolved[pred] = exhausted ? 0 : unresolved[pred] - 1;
+                    if (lost) {
+                        visit(pred, level + 1, next);
+                    } else if (exhausted) {
+                        visit(pred, level + 1, next, true);
+                    }
+                });
+            }
+            if (level + 1 < static_cast<int>(pending.size())) {
+                std::vector<uint32_t> queued;
+                queued.swap(pending[level + 1]);
+                for (uint32_t idx : queued) visit(idx, level + 1, next);
+            }
+            if (missingTable) return false;
+            frontier.swap(next);
+        }
+
+        out.assign(entries, 0);
+        uint64_t wins = 0, losses = 0, draws = 0;
+        int longest = 0;
+        for (uint32_t idx = 0; idx < entries; idx++) {
+            uint16_t w = work[idx];
+            if (w == WORK_ILLEGAL) {
+                out[idx] = TB_ILLEGAL;
+            } else if (w < WORK_DECIDED) {
+                draws++;
+            } else {
+                int plies = w - WORK_DECIDED;
+                longest = std::max(longest, plies);
+                if (plies % 2) {
+                    wins++;
+                    out[idx] = static_cast<uint8_t>(std::min((plies + 1) / 2, 127));
+                } else {
+                    losses++;
+                    out[idx] = static_cast<uint8_t>(TB_ILLEGAL + 1 + std::min(plies / 2, 126));
+                }
+            }
+        }
+        if (log) {
+            *log << table.signature << ": " << entries << " entries, " << wins << " wins, " << losses
+                 << " losses, " << draws << " draws, longest mate " << (longest + 1) / 2 << " moves";
+            if (longest > 2 * 126) *log << " (distances capped)";
+            *log << std::endl;
+        }
+        work.clear();
+        work.shrink_to_fit();
+        unresolved.clear();
+        unresolved.shrink_to_fit();
+        return true;
+    }
+
+private:
+    const TablebaseFile& table;
+    const Tablebase& smaller;
+    std::vector<uint16_t> work;
+    // In-table successors not yet known to win for the opponent, counted as
+    // distinct indices. Each of them reaches the position at least once by
+    // un-moving, so the loss check can wait until the count runs out.
+    // Double pushes are left out: en passant can settle them without ever
+    // being un-moved, and they are re-examined through 'pending' instead.
+    std::vector<uint8_t> unresolved;
+    std::vector<std::vector<uint32_t>> pending;  // re-examine at this distance
+    bool missingTable = false;
+
+    // Canonical, no overlapping pieces, and the side not to move not in check
+    bool isLegal(const TablebasePosition& pos, uint32_t idx) const {
+        int occ[64];
+        std::fill(occ, occ + 64, 0);
+        for (int i = 0; i < pos.count; i++) {
+            if (occ[pos.square[i]]) return false;
+            occ[pos.square[i]] = i + 1;
+        }
+        if (table.index(pos) != int64_t(idx)) return false;
+        return !kingAttacked(pos, occ, !pos.whiteToMove);
+    }
+
+    // 'quick' only looks for a loss and gives up at the first move that
+    // doesn't lose
+    void visit(uint32_t idx, int level, std::vector<uint32_t>& decided, bool quick = false) {
+        if (work[idx] != WORK_UNKNOWN) return;
+        int recheck = 0;
+        uint16_t result = examine(idx, level, recheck, quick);
+        if (result != WORK_UNKNOWN) {
+            work[idx] = result;
+            if (result >= WORK_DECIDED) decided.push_back(idx);
+        } else if (recheck > level) {
+            if (static_cast<int>(pending.size()) <= recheck) pending.resize(recheck + 1);
+            pending[recheck].push_back(idx);
+        }
+    }
+
+    // Value of a position leaving the table (capture or promotion)
+    Outcome probeSmaller(const TablebasePosition& child) {
+        Outcome o;
+        o.known = smaller.probe(child, o.value);
+        if (!o.known) missingTable = true;
+        return o;
+    }
+
+    // Value of an in-table child. Everything decided so far is at most
+    // 'level' plies from mate; anything undecided is further or a draw.
+    // 'pushed' is the square of a pawn that just moved two squares, else -1.
+    Outcome inTable(const TablebasePosition& child, int64_t idx, int pushed, int level, int& recheck) {
+        Outcome o;
+        uint16_t w = idx >= 0 ? work[idx] : WORK_ILLEGAL;
+        if (w >= WORK_DRAW) {
+            o.known = true;
+            o.value = fromWork(w);
+        }
+
+        // After a double push the opponent may take en passant, which leaves
+        // the table: the child is worth the better of the two for them
+        if (pushed < 0) return o;
+        bool white = !child.whiteToMove;
+        int pusher = 0;
+        while (child.square[pusher] != pushed) pusher++;
+        int occ[64];
+        fillOccupancy(child, occ);
+        int passed = child.square[pusher] + (white ? -8 : 8);
+        Outcome best;
+        for (int i = 0; i < child.count; i++) {
+            if (child.piece[i] != (white ? BLACK_PAWN : WHITE_PAWN)) continue;
+            if (child.square[i] / 8 != child.square[pusher] / 8 || std::abs(child.square[i] % 8 - child.square[pusher] % 8) != 1) continue;
+            TablebasePosition after = applyMove(child, GenMove{i, passed, pusher, 0, false});
+            int afterOcc[64];
+            fillOccupancy(after, afterOcc);
+            if (kingAttacked(after, afterOcc, child.whiteToMove)) continue;
+            Outcome taken = probeSmaller(after);
+            if (!taken.known) continue;
+            TablebaseValue forTaker{-taken.value.wdl, taken.value.wdl == 0 ? 0 : taken.value.plies + 1};
+            if (!best.known || preference(forTaker) > preference(best.value)) {
+                best.known = true;
+                best.value = forTaker;
+            }
+        }
+        if (!best.known) return o;
+        if (o.known) {
+            if (preference(best.value) > preference(o.value)) o.value = best.value;
+            return o;
+        }
+        // An undecided child is at least 'level' plies from mate, so a win
+        // by en passant no longer than that is the opponent's best
+        if (best.value.wdl > 0 && best.value.plies <= level) return best;
+        if (best.value.wdl > 0) recheck = recheck ? std::min(recheck, best.value.plies) : best.value.plies;
+        return o;
+    }
+
+    // Decide a position from its moves if possible. 'recheck' gets the
+    // distance at which a move leaving the table would settle it.
+    uint16_t examine(uint32_t idx, int level, int& recheck, bool quick) {
+        TablebasePosition pos;
+        table.decode(idx, pos);
+        int occ[64];
+        fillOccupancy(pos, occ);
+        GenMove moves[256];
+        int n = generateMoves(pos, occ, moves);
+
+        int legal = 0;
+        int64_t successors[256];
+        int successorCount = 0;
+        bool unknown = false, drawn = false;
+        int bestWin = -1, slowestLoss = -1;
+        for (int m = 0; m < n; m++) {
+            TablebasePosition child = applyMove(pos, moves[m]);
+            int childOcc[64];
+            std::copy(occ, occ + 64, childOcc);
+            childOcc[pos.square[moves[m].slot]] = 0;
+            childOcc[moves[m].to] = 1;
+            if (kingAttacked(child, childOcc, pos.whiteToMove)) continue;
+            legal++;
+            Outcome o;
+            if (moves[m].captured >= 0 || moves[m].promotion) {
+                o = probeSmaller(child);
+            } else {
+                int64_t c = table.index(child);
+                o = inTable(child, c, moves[m].doublePush ? moves[m].to : -1, level, recheck);
+                if (level == 0 && !moves[m].doublePush && std::find(successors, successors + successorCount, c) == successors + successorCount) {
+                    successors[successorCount++] = c;
+                }
+            }
+            if (quick && (!o.known || o.value.wdl <= 0)) return WORK_UNKNOWN;
+            if (!o.known) {
+                unknown = true;
+            } else if (o.value.wdl < 0) {
+                int win = o.value.plies + 1;
+                if (bestWin < 0 || win < bestWin) bestWin = win;
+            } else if (o.value.wdl == 0) {
+                drawn = true;
+            } else {
+                slowestLoss = std::max(slowestLoss, o.value.plies + 1);
+            }
+        }
+
+        if (level == 0) unresolved[idx] = static_cast<uint8_t>(std::min(successorCount, 255));
+        if (legal == 0) return kingAttacked(pos, occ, pos.whiteToMove) ? WORK_DECIDED : WORK_DRAW;
+        auto later = [&](int d) { recheck = recheck ? std::min(recheck, d) : d; };
+        // An undecided child is at least 'level' plies from mate, so a
+        // known win no longer than 'level' + 1 can't be beaten
+        if (bestWin >= 0) {
+            if (bestWin <= level) return toWork(TablebaseValue{1, bestWin});
+            later(bestWin);
+            return WORK_UNKNOWN;
+        }
+        if (unknown) return WORK_UNKNOWN;
+        if (drawn) return WORK_DRAW;
+        if (slowestLoss <= level) return toWork(TablebaseValue{-1, slowestLoss});
+        later(slowestLoss);
+        return WORK_UNKNOWN;
+    }
+
+    // Positions one move before 'pos' that stay in the table (no captures
+    // or promotions, those lead out of it)
+    template <class Visit>
+    void forEachPredecessor(const TablebasePosition& pos, Visit visitPred) {
+        int occ[64];
+        fillOccupancy(pos, occ);
+        const bool moverWhite = !pos.whiteToMove;
+        auto emit = [&](int slot, int from, bool doublePush = false) {
+            TablebasePosition prev = pos;
+            prev.square[slot] = from;
+            prev.whiteToMove = moverWhite;
+            int64_t idx = table.index(prev);
+            if (idx >= 0) visitPred(static_cast<uint32_t>(idx), doublePush);
+        };
+        for (int i = 0; i < pos.count; i++) {
+            int piece = pos.piece[i];
+            if (isWhitePiece(piece) != moverWhite) continue;
+            int to = pos.square[i], rank = to / 8, file = to % 8;
+            switch (pieceType(piece)) {
+            case 1: {
+                int back = moverWhite ? -8 : 8;
+                int from = to + back;
+                if (from / 8 < 1 || from / 8 > 6 || occ[from]) break;
+                emit(i, from);
+                if (rank == (moverWhite ? 3 : 4) && !occ[from + back]) emit(i, from + back, true);
+                break;
+            }
+            case 3:
+            case 6: {
+                const int (*steps)[2] = pieceType(piece) == 3 ? KNIGHT_STEPS : KING_STEPS;
+                for (int d = 0; d < 8; d++) {
+                    int r = rank + steps[d][0], f = file + steps[d][1];
+                    if (onBoard(r, f) && !occ[r * 8 + f]) emit(i, r * 8 + f);
+                }
+                break;
+            }
+            default: {
+                int type = pieceType(piece);
+                for (int d = (type == 4 ? 4 : 0); d < (type == 2 ? 4 : 8); d++) {
+                    for (int r = rank + KING_STEPS[d][0], f = file + KING_STEPS[d][1];
+                         onBoard(r, f) && !occ[r * 8 + f]; r += KING_STEPS[d][0], f += KING_STEPS[d][1]) {
+                        emit(i, r * 8 + f);
+                    }
+                }
+                break;
+            }
+            }
+        }
+    }
+};
+}  // namespace
+
+// Tables this one converts into: one piece captured, or one pawn promoted
+static std::vector<std::string> conversions(const std::string& signature) {
+    std::vector<int> white, black;
+    parseSignature(signature, white, black);
+    std::vector<std::string> result;
+    auto add = [&](const std::vector<int>& w, const std::vector<int>& b) {
+        std::vector<int> ws = w, bs = b;
+        sortSide(ws);
+        sortSide(bs);
+        std::string sig = canonicalSignature(sideName(ws) + sideName(bs));
+        if (ws.size() + bs.size() > 0 && std::find(result.begin(), result.end(), sig) == result.end()) result.push_back(sig);
+    };
+    for (int side = 0; side < 2; side++) {
+        const std::vector<int>& own = side == 0 ? white : black;
+        for (size_t i = 0; i < own.size(); i++) {
+            std::vector<int> fewer = own;
+            fewer.erase(fewer.begin() + i);
+            side == 0 ? add(fewer, black) : add(white, fewer);
+            if (own[i] != 1) continue;
+            for (int type : {5, 2, 4, 3}) {
+                std::vector<int> promoted = own;
+                promoted[i] = type;
+                side == 0 ? add(promoted, black) : add(white, promoted);
+            }
+        }
+    }
+    return result;
+}
+
+static bool generateTablebase(const std::string& dir, const std::string& sig, Tablebase& tables, std::ostream* log,
+                              std::vector<std::string>& visited) {
+    if (std::find(visited.begin(), visited.end(), sig) != visited.end()) return true;
+    visited.push_back(sig);
+    // Smaller tables first, including those of a table already on disk: a
+    // capture-promotion skips a level (KQKP -> KRK through KPK)
+    for (const std::string& smaller : conversions(sig)) {
+        if (!generateTablebase(dir, smaller, tables, log, visited)) return false;
+    }
+    if (tables.hasTable(sig)) return true;
+    std::string path = (fs::path(dir) / (sig + ".ctb")).string();
+    if (fs::exists(path) && tables.loadFile(path)) return true;
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    TablebaseFile table(sig);
+    std::vector<uint8_t> entries;
+    Generator generator(table, tables);
+    if (!generator.run(entries, log)) {
+        if (log) *log << sig << ": a smaller table is missing" << std::endl;
+        return false;
+    }
+    if (!writeTableFile(path, table, entries) || !tables.loadFile(path)) {
+        if (log) *log << "cannot write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool generateTablebase(const std::string& dir, const std::string& signature, Tablebase& tables, std::ostream* log) {
+    std::string sig = canonicalSignature(signature);
+    if (sig.empty()) {
+        if (log) *log << "bad signature " << signature << std::endl;
+        return false;
+    }
+    std::vector<std::string> visited;
+    return generateTablebase(dir, sig, tables, log, visited);
+}
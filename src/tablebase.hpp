@@ -0,0 +1,92 @@
+#pragma once
+#include "materialKey.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ChessGame;
+
+// Endgame tablebases for up to TB_MAX_PIECES pieces (kings included),
+// generated locally by retrograde analysis (generateTablebase, chess_tbgen)
+// and memory-mapped for probing.
+//
+// One file per material signature, named after it ("KQKR.ctb"): the side
+// listed first is the stronger one and plays white in the file. Positions
+// with the colours reversed probe the same file mirrored. Each position with
+// either side to move has one byte, its distance to mate in moves:
+//   0 = draw, 1..127 = side to move mates in N, 129 + N = side to move is
+//   mated in N (N = 0: already mated), 128 = illegal or duplicate index.
+// Distances are capped at 126/127 moves. The tables assume no castling or
+// en passant rights and ignore the fifty-move rule; positions with either
+// right are not probed.
+
+constexpr int TB_MAX_PIECES = 5;
+
+// Outcome for the side to move under perfect play
+struct TablebaseValue {
+    int wdl = 0;    // 1 win, 0 draw, -1 loss
+    int plies = 0;  // to mate (odd for a win, even for a loss), 0 for a draw
+};
+
+// A position as the generator and the index see it: squares are
+// rank * 8 + file with rank 0 = white's first rank (unlike the board's
+// row 0 = rank 8), pieces are board codes
+struct TablebasePosition {
+    int count = 0;
+    int square[TB_MAX_PIECES];
+    int piece[TB_MAX_PIECES];
+    bool whiteToMove = true;
+};
+
+class TablebaseFile;
+
+class Tablebase {
+public:
+    Tablebase();
+    ~Tablebase();
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    // Map every .ctb file in 'dir' (tables already mapped are kept); returns
+    // the number of new tables, or -1 if the directory can't be read
+    int load(const std::string& dir);
+    // Map a single table file; false if it is missing or malformed
+    bool loadFile(const std::string& path);
+    void clear();
+
+    size_t tableCount() const { return files.size(); }
+    int maxPieces() const { return largest; }
+    bool hasTable(const std::string& signature) const;
+
+    // Probe the current position of 'game' (the global board). False when no
+    // table covers it or castling / en passant rights exist.
+    bool probe(const ChessGame& game, TablebaseValue& value) const;
+    bool probe(const TablebasePosition& pos, TablebaseValue& value) const;
+
+private:
+    struct Entry {
+        const TablebaseFile* file;
+        bool flipped;  // colours reversed relative to the file
+    };
+    std::vector<std::unique_ptr<TablebaseFile>> files;
+    std::unordered_map<MaterialKey, Entry> byMaterial;
+    int largest = 0;
+};
+
+// Canonical name for a set of pieces, e.g. "KRKP" for white K+R against
+// black K+P and for the colour-reversed set. Empty if 'signature' (any
+// "K...K..." string) is malformed or has more than TB_MAX_PIECES pieces.
+std::string canonicalSignature(const std::string& signature);
+
+// Every canonical signature with 3..maxPieces pieces, smallest first
+std::vector<std::string> allSignatures(int maxPieces);
+
+// Generate the table for 'signature' into 'dir', first generating any
+// missing table it converts into by captures and promotions. Tables already
+// in 'tables' (or on disk in 'dir') are reused; new ones are mapped into
+// 'tables'. Progress goes to 'log' if given. False on an I/O error or a bad
+// signature.
+bool generateTablebase(const std::string& dir, const std::string& signature, Tablebase& tables, std::ostream* log = nullptr);
@@ -0,0 +1,88 @@
+#include "game.hpp"
+#include "attackMaps.hpp"
+#include <iostream>
+
+using namespace std;
+
+// Straightforward mailbox reference: squares attacked by the piece on (row, col)
+static Bitboard referenceAttacks(int row, int col) {
+    int piece = board[row][col];
+    int type = piece & 0b0111;
+    bool white = isWhite(piece);
+    Bitboard att = 0;
+    auto addIf = [&](int r, int c) {
+        if (r >= 0 && r < 8 && c >= 0 && c < 8) att |= squareBit(r * 8 + c);
+    };
+    auto ray = [&](int dr, int dc) {
+        for (int r = row + dr, c = col + dc; r >= 0 && r < 8 && c >= 0 && c < 8; r += dr, c += dc) {
+            att |= squareBit(r * 8 + c);
+            if (board[r][c] != EMPTY) break;
+        }
+    };
+    switch (type) {
+        case 0b0001: {
+            int dr = white ? -1 : 1;
+            addIf(row + dr, col - 1);
+            addIf(row + dr, col + 1);
+            break;
+        }
+        case 0b0011:
+            for (auto [dr, dc] : {pair{-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}}) addIf(row + dr, col + dc);
+            break;
+        case 0b0110:
+            for (int dr = -1; dr <= 1; ++dr)
+                for (int dc = -1; dc <= 1; ++dc)
+                    if (dr || dc) addIf(row + dr, col + dc);
+            break;
+        default:
+            if (type == 0b0010 || type == 0b0101) { ray(-1, 0); ray(1, 0); ray(0, -1); ray(0, 1); }
+            if (type == 0b0100 || type == 0b0101) { ray(-1, -1); ray(-1, 1); ray(1, -1); ray(1, 1); }
+            break;
+    }
+    return att;
+}
+
+int main() {
+    cout << "=== ATTACK MAP TEST ===" << endl << endl;
+
+    vector<string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+        "Q6n/8/8/8/8/8/8/N5kB w - - 0 1",  // pieces in the corners (file wrap)
+    };
+
+    int passed = 0;
+    for (const string& fen : fens) {
+        ChessGame game;
+        game.loadFEN(fen);
+        AttackMaps maps;
+        computeAttackMaps(board, maps);
+
+        Bitboard expected[2][7] = {};
+        Bitboard expectedTwice[2] = {};
+        for (int row = 0; row < 8; ++row) {
+            for (int col = 0; col < 8; ++col) {
+                int piece = board[row][col];
+                if (piece == EMPTY) continue;
+                int c = isWhite(piece) ? 0 : 1;
+                Bitboard att = referenceAttacks(row, col);
+                expectedTwice[c] |= expected[c][0] & att;
+                expected[c][piece & 0b0111] |= att;
+                expected[c][0] |= att;
+            }
+        }
+
+        bool ok = true;
+        for (int c = 0; c < 2; ++c) {
+            for (int t = 0; t < 7; ++t) ok &= maps.attacks[c][t] == expected[c][t];
+            ok &= maps.attackedTwice[c] == expectedTwice[c];
+        }
+        cout << (ok ? "PASS " : "FAIL ") << fen << endl;
+        if (ok) passed++;
+    }
+
+    cout << endl << "RESULTS: " << passed << "/" << fens.size() << " tests passed" << endl;
+    return passed == (int)fens.size() ? 0 : 1;
+}
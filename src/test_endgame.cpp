@@ -0,0 +1,196 @@
+#include "game.hpp"
+#include "engine.hpp"
+#include "evaluation.hpp"
+#include "endgame.hpp"
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+// FEN for white king, white pawn and black king on board squares (row * 8 + col)
+static string kpkFen(int whiteKing, int pawn, int blackKing, bool whiteToMove) {
+    string placement;
+    for (int row = 0; row < 8; row++) {
+        int empty = 0;
+        for (int col = 0; col < 8; col++) {
+            int sq = row * 8 + col;
+            char c = sq == whiteKing ? 'K' : sq == pawn ? 'P' : sq == blackKing ? 'k' : 0;
+            if (!c) { empty++; continue; }
+            if (empty) placement += char('0' + empty);
+            empty = 0;
+            placement += c;
+        }
+        if (empty) placement += char('0' + empty);
+        if (row < 7) placement += '/';
+    }
+    return placement + (whiteToMove ? " w - - 0 1" : " b - - 0 1");
+}
+
+int main() {
+    cout << "=== ENDGAME TEST ===" << endl << endl;
+
+    int passed = 0;
+    int total = 0;
+    auto check = [&](bool ok, const string& what) {
+        cout << (ok ? "PASS " : "FAIL ") << what << endl;
+        total++;
+        if (ok) passed++;
+    };
+
+    // Material key follows make/undo through captures and promotions
+    {
+        mt19937 rng(7);
+        bool ok = true;
+        for (const char* fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+                                "1r2k3/P1P5/8/8/8/8/1p1p4/R3K3 w - - 0 1"}) {
+            for (int gameNo = 0; gameNo < 20; gameNo++) {
+                ChessGame game;
+                game.loadFEN(fen);
+                int plies = 0;
+                for (; plies < 60; plies++) {
+                    vector<Move> moves = game.getLegalMoves();
+                    if (moves.empty()) break;
+                    game.makeMoveForEngine(moves[rng() % moves.size()]);
+                    ok &= game.getMaterialKey() == computeMaterialKey(board);
+                }
+                for (; plies > 0; plies--) {
+                    game.undoMove();
+                    ok &= game.getMaterialKey() == computeMaterialKey(board);
+                }
+            }
+        }
+        check(ok, "material key matches the board after make/undo");
+    }
+
+    // Insufficient material from the material key
+    {
+        struct Case { const char* fen; bool draw; };
+        const Case cases[] = {
+            {"8/8/4k3/8/8/3K4/8/8 w - - 0 1", true},
+            {"8/8/4k3/8/8/3KN3/8/8 w - - 0 1", true},
+            {"8/8/4kb2/8/8/3K4/8/8 w - - 0 1", true},
+            {"8/8/4kb2/8/8/3KB3/8/8 w - - 0 1", true},    // same-coloured bishops
+            {"8/8/4k1b1/8/8/3KB3/8/8 w - - 0 1", false},  // opposite-coloured bishops
+            {"8/8/4k3/8/8/3KNN2/8/8 w - - 0 1", false},
+            {"8/8/4k3/8/8/3KP3/8/8 w - - 0 1", false},
+            {"8/8/4k3/8/8/3KR3/8/8 w - - 0 1", false},
+        };
+        bool ok = true;
+        ChessGame game;
+        for (const Case& c : cases) {
+            game.loadFEN(c.fen);
+            if (game.isDrawByInsufficientMaterial() != c.draw) {
+                cout << "  wrong for " << c.fen << endl;
+                ok = false;
+            }
+        }
+        check(ok, "insufficient material");
+    }
+
+    // KPK textbook positions
+    {
+        struct Case { const char* fen; bool win; };
+        const Case cases[] = {
+            {"4k3/8/4K3/4P3/8/8/8/8 w - - 0 1", true},   // king on the 6th in front of the pawn
+            {"4k3/8/4K3/4P3/8/8/8/8 b - - 0 1", true},
+            {"4k3/4P3/4K3/8/8/8/8/8 w - - 0 1", true},   // Kd6 Kf7 Kd7
+            {"4k3/4P3/4K3/8/8/8/8/8 b - - 0 1", false},  // stalemate
+            {"k7/8/8/P1K5/8/8/8/8 w - - 0 1", false},    // rook pawn, defender in the corner
+            {"7k/8/8/8/P7/8/8/7K w - - 0 1", true},      // outside the square
+            {"8/8/8/8/k7/1P6/8/7K b - - 0 1", false},    // pawn falls
+            {"8/8/8/8/8/4k3/4p3/4K3 w - - 0 1", false},  // black pawn, stalemate
+            {"8/8/8/8/4p3/4k3/8/4K3 b - - 0 1", true},   // black pawn, king in front
+        };
+        bool ok = true;
+        ChessGame game;
+        for (const Case& c : cases) {
+            game.loadFEN(c.fen);
+            if (kpkIsWin(board, game.isWhiteToMove()) != c.win) {
+                cout << "  wrong for " << c.fen << endl;
+                ok = false;
+            }
+        }
+        check(ok, "KPK bitbase textbook positions");
+    }
+
+    // Bitbase agrees with itself through the real move generator: the pawn
+    // side wins iff some move wins, the defender loses iff every move loses
+    {
+        mt19937 rng(11);
+        ChessGame game;
+        int tested = 0, mismatches = 0;
+        while (tested < 20000) {
+            int whiteKing = rng() % 64, pawn = 8 + rng() % 48, blackKing = rng() % 64;
+            bool whiteToMove = rng() % 2;
+            if (whiteKing == pawn || blackKing == pawn || whiteKing == blackKing) continue;
+            if (max(abs(whiteKing / 8 - blackKing / 8), abs(whiteKing % 8 - blackKing % 8)) <= 1) continue;
+            if (whiteToMove && pawn / 8 == 1) continue;  // promotions: the bitbase only counts safe queens
+            // Black, not to move, may not be in check from the pawn
+            if (whiteToMove && blackKing / 8 == pawn / 8 - 1 && abs(blackKing % 8 - pawn % 8) == 1) continue;
+            game.loadFEN(kpkFen(whiteKing, pawn, blackKing, whiteToMove));
+
+            bool expected = !whiteToMove;  // all() over no moves is true, any() false
+            vector<Move> moves = game.getLegalMoves();
+            for (const Move& m : moves) {
+                game.makeMoveForEngine(m);
+                bool childWin = materialCount(game.getMaterialKey(), WHITE_PAWN) == 1 && kpkIsWin(board, game.isWhiteToMove());
+                game.undoMove();
+                if (whiteToMove) expected = expected || childWin;
+                else expected = expected && childWin;
+            }
+            if (moves.empty()) expected = !whiteToMove && game.isInCheck();
+            if (kpkIsWin(board, whiteToMove) != expected) mismatches++;
+            tested++;
+        }
+        check(mismatches == 0, "KPK bitbase consistent with move generation (" + to_string(tested) +
+                                   " positions, " + to_string(mismatches) + " mismatches)");
+    }
+
+    // Endgame scores and scaling in the evaluation
+    {
+        Evaluation eval;
+        ChessGame game;
+        bool ok = true;
+        game.loadFEN("8/8/4k3/8/8/3KR3/8/8 w - - 0 1");
+        ok &= eval.evaluate(game) > KNOWN_WIN;
+        game.loadFEN("8/8/4K3/8/8/3kq3/8/8 b - - 0 1");
+        ok &= eval.evaluate(game) < -KNOWN_WIN;
+        game.loadFEN("8/8/4k3/8/8/3KN3/8/8 w - - 0 1");
+        ok &= eval.evaluate(game) == 0.0;
+        game.loadFEN("k7/8/8/P1K5/8/8/8/8 w - - 0 1");
+        ok &= eval.evaluate(game) == 0.0;
+        game.loadFEN("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1");
+        ok &= eval.evaluate(game) > KNOWN_WIN;
+        game.loadFEN("k7/8/8/8/8/8/8/KBN5 w - - 0 1");  // light-squared bishop: mates on a8/h1
+        double nearCorner = eval.evaluate(game);
+        game.loadFEN("7k/8/8/8/8/8/8/KBN5 w - - 0 1");
+        ok &= nearCorner > eval.evaluate(game) && nearCorner > KNOWN_WIN;
+        game.loadFEN("8/8/4k3/8/8/3KR3/8/5b2 w - - 0 1");  // KRKB scaled towards a draw
+        ok &= std::abs(eval.evaluate(game)) < 1.0;
+        game.loadFEN("k7/8/8/P7/8/8/3B4/K7 w - - 0 1");  // wrong rook pawn, defender in the corner
+        ok &= eval.evaluate(game) == 0.0;
+        game.loadFEN("8/8/4k3/8/8/3KR3/8/8 w - - 0 1");
+        ok &= eval.evaluate(game, -1.0, 1.0) == eval.evaluate(game);
+        check(ok, "endgame evaluation and scaling");
+    }
+
+    // The search sees through a drawn KPK instantly instead of searching it out
+    {
+        Evaluation eval;
+        Engine engine(eval);
+        ChessGame game;
+        game.loadFEN("k7/8/8/P1K5/8/8/8/8 w - - 0 1");
+        engine.getBestMove(game, 8);
+        double drawScore = engine.getLastResult().score;
+        game.loadFEN("8/8/8/8/4p3/4k3/8/4K3 b - - 0 1");
+        engine.newGame();
+        engine.getBestMove(game, 8);
+        double winScore = engine.getLastResult().score;
+        cout << "INFO KPK draw scored " << drawScore << ", win scored " << winScore << endl;
+        check(std::abs(drawScore) < 0.5 && winScore < -KNOWN_WIN, "search scores KPK from the bitbase");
+    }
+
+    cout << endl << "RESULTS: " << passed << "/" << total << " tests passed" << endl;
+    return passed == total ? 0 : 1;
+}
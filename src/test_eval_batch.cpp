@@ -0,0 +1,102 @@
+#include "game.hpp"
+#include "evaluation.hpp"
+#include "positionBatch.hpp"
+#include "endgame.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+// Exposes the per-term functions so the batch result can be checked term by term
+class BatchCheckEvaluation : public Evaluation {
+public:
+    // The terms evaluateBatch covers, computed one position at a time from the global board
+    double batchTerms(const ChessGame& game) const {
+        const EndgameEntry* ending = findEndgame(game.getMaterialKey());
+        if (ending && ending->evaluate) return ending->value(board, game.isWhiteToMove());
+        AttackMaps maps;
+        computeAttackMaps(board, maps);
+        double terms = materialCount(game) + activity(maps) + 0.01*position(game);
+        return ending ? terms * ending->scale(board, ending->strong) : terms;
+    }
+};
+
+int main() {
+    cout << "=== BATCH EVALUATION TEST ===" << endl << endl;
+
+    // Positions from random games
+    mt19937 rng(2024);
+    vector<PackedPosition> positions;
+    vector<double> expected;
+    BatchCheckEvaluation eval;
+    for (int gameNo = 0; gameNo < 40; gameNo++) {
+        ChessGame game;
+        for (int ply = 0; ply < 80; ply++) {
+            vector<Move> moves = game.getLegalMoves();
+            if (moves.empty()) break;
+            game.makeMoveForEngine(moves[rng() % moves.size()]);
+            positions.push_back(PackedPosition::fromBoard(board, game.isWhiteToMove()));
+            expected.push_back(eval.batchTerms(game));
+        }
+    }
+    // Known endings: exact scores (KPK, KRK, KNK) and a scaled one (KRKN)
+    for (const char* fen : {"8/8/8/4k3/8/8/4P3/4K3 w - - 0 1", "8/8/3k4/8/8/8/8/R3K3 b - - 0 1",
+                            "8/8/3k4/8/8/8/8/1N2K3 w - - 0 1", "8/8/3kn3/8/8/8/8/R3K3 w - - 0 1"}) {
+        ChessGame game;
+        game.loadFEN(fen);
+        positions.push_back(PackedPosition::fromBoard(board, game.isWhiteToMove()));
+        expected.push_back(eval.batchTerms(game));
+    }
+
+    int passed = 0;
+    int total = 0;
+
+    // Packing round trip
+    {
+        bool ok = true;
+        ChessGame game;
+        game.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1");
+        PackedPosition p = PackedPosition::fromBoard(board, game.isWhiteToMove());
+        int b[8][8];
+        p.toBoard(b);
+        for (int sq = 0; sq < 64; sq++) ok &= b[sq / 8][sq % 8] == board[sq / 8][sq % 8];
+        ok &= !p.whiteToMove;
+        cout << (ok ? "PASS " : "FAIL ") << "PackedPosition round trip" << endl;
+        total++;
+        if (ok) passed++;
+    }
+
+    // Batch matches the single-position terms, single-threaded and threaded
+    PositionBatch batch(positions);
+    for (int threads : {1, 4}) {
+        vector<double> out(batch.size());
+        eval.evaluateBatch(batch, out.data(), threads);
+        int mismatches = 0;
+        for (size_t i = 0; i < out.size(); i++) {
+            if (std::abs(out[i] - expected[i]) > 1e-9) mismatches++;
+        }
+        bool ok = mismatches == 0;
+        cout << (ok ? "PASS " : "FAIL ") << batch.size() << " positions, " << threads
+             << " thread(s): " << mismatches << " mismatches" << endl;
+        total++;
+        if (ok) passed++;
+    }
+
+    // Throughput, for information
+    {
+        vector<PackedPosition> many;
+        for (int i = 0; i < 50; i++) many.insert(many.end(), positions.begin(), positions.end());
+        PositionBatch big(many);
+        vector<double> out(big.size());
+        auto start = chrono::steady_clock::now();
+        eval.evaluateBatch(big, out.data());
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cout << "INFO " << big.size() << " positions in " << ms << " ms ("
+             << (ms > 0 ? big.size() / ms * 1000.0 : 0.0) << " positions/s)" << endl;
+    }
+
+    cout << endl << "RESULTS: " << passed << "/" << total << " tests passed" << endl;
+    return passed == total ? 0 : 1;
+}
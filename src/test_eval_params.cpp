@@ -0,0 +1,89 @@
+#include "game.hpp"
+#include "evaluation.hpp"
+#include "evalParams.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+
+static bool sameParams(const EvalParams& a, const EvalParams& b) {
+    return memcmp(&a, &b, sizeof(EvalParams)) == 0;
+}
+
+static void writeFile(const string& path, const string& text) {
+    ofstream out(path);
+    out << text;
+}
+
+int main() {
+    cout << "=== EVALUATION PARAMETER FILE TEST ===" << endl << endl;
+
+    const string path = "test_eval_params.tmp";
+    int passed = 0;
+    int total = 0;
+    auto check = [&](bool ok, const string& what) {
+        cout << (ok ? "PASS " : "FAIL ") << what << endl;
+        total++;
+        if (ok) passed++;
+    };
+
+    // Save then load gives back the same parameters
+    {
+        EvalParams modified = defaultEvalParams();
+        modified.material[5] = 950;
+        modified.pstEg[3][27] = -17;
+        modified.threatByRook = 42;
+        EvalParams loaded = defaultEvalParams();
+        bool ok = saveEvalParams(path, modified) && loadEvalParams(path, loaded);
+        check(ok && sameParams(loaded, modified), "save/load round trip");
+    }
+
+    // Partial file with comments: listed groups change, the rest are kept
+    {
+        writeFile(path, "# hand edit\nmaterial 0 80 500 300 300 900 0  # cheaper pawns\nhanging_piece 33\n");
+        EvalParams loaded = defaultEvalParams();
+        EvalParams expected = defaultEvalParams();
+        expected.material[1] = 80;
+        expected.hangingPiece = 33;
+        check(loadEvalParams(path, loaded) && sameParams(loaded, expected), "partial file keeps other groups");
+    }
+
+    // Bad files are rejected and leave the parameters untouched
+    {
+        const char* bad[] = {"material 0 100 500\n", "no_such_group 1\n", "king_attack_max lots\n"};
+        bool ok = true;
+        for (const char* text : bad) {
+            writeFile(path, text);
+            EvalParams loaded = defaultEvalParams();
+            ok &= !loadEvalParams(path, loaded) && sameParams(loaded, defaultEvalParams());
+        }
+        EvalParams loaded;
+        ok &= !loadEvalParams("no/such/file.txt", loaded);
+        check(ok, "malformed and missing files rejected");
+    }
+    remove(path.c_str());
+
+#ifdef EVAL_FROZEN_PARAMS
+    cout << "INFO frozen build, runtime parameter switching not tested" << endl;
+#else
+    // The evaluation follows setEvalParams
+    {
+        ChessGame game;
+        game.loadFEN("1n2k3/8/8/8/8/8/4P3/1N2K3 w - - 0 1");  // no endgame entry (endgame.hpp)
+        Evaluation eval;
+        double before = eval.evaluate(game);
+        EvalParams params = defaultEvalParams();
+        params.material[1] += 100;
+        setEvalParams(params);
+        double after = eval.evaluate(game);
+        setEvalParams(defaultEvalParams());
+        double restored = eval.evaluate(game);
+        check(std::abs(after - before - 1.0) < 1e-9 && restored == before, "evaluation uses the active parameters");
+    }
+#endif
+
+    cout << endl << "RESULTS: " << passed << "/" << total << " tests passed" << endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+#include "game.hpp"
+#include "evaluation.hpp"
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+int main() {
+    cout << "=== LAZY EVALUATION TEST ===" << endl << endl;
+
+    Evaluation eval;
+    mt19937 rng(44);
+    int passed = 0;
+    int total = 0;
+    auto check = [&](bool ok, const string& what) {
+        cout << (ok ? "PASS " : "FAIL ") << what << endl;
+        total++;
+        if (ok) passed++;
+    };
+
+    // Positions from random games, each tried against windows below, around
+    // and above its score: an early exit must be a bound on the correct side
+    int positions = 0, windows = 0, wrongSide = 0, inexact = 0, lazyExits = 0;
+    double worstTight = 0.0;
+    for (int gameNo = 0; gameNo < 200; gameNo++) {
+        ChessGame game;
+        for (int ply = 0; ply < 120; ply++) {
+            vector<Move> moves = game.getLegalMoves();
+            if (moves.empty()) break;
+            game.makeMoveForEngine(moves[rng() % moves.size()]);
+            positions++;
+
+            double full = eval.evaluate(game);
+            worstTight = max(worstTight, std::abs(full - eval.evaluate(game, full - 1e-6, full + 1e-6)));
+            for (int w = 0; w < 8; w++) {
+                double center = full + uniform_real_distribution<double>(-6.0, 6.0)(rng);
+                double width = uniform_real_distribution<double>(0.0, 2.0)(rng);
+                double alpha = center - width, beta = center + width;
+                double lazy = eval.evaluate(game, alpha, beta);
+                windows++;
+                if (lazy <= alpha) {
+                    if (full > lazy + 1e-9) wrongSide++;
+                    if (lazy != full) lazyExits++;
+                } else if (lazy >= beta) {
+                    if (full < lazy - 1e-9) wrongSide++;
+                    if (lazy != full) lazyExits++;
+                } else if (std::abs(lazy - full) > 1e-9) {
+                    inexact++;
+                }
+            }
+        }
+    }
+    cout << "INFO " << positions << " positions, " << windows << " windows, " << lazyExits << " lazy exits" << endl;
+    check(wrongSide == 0, "early exits bound the full evaluation (" + to_string(wrongSide) + " on the wrong side)");
+    check(inexact == 0, "inside the window the result is exact (" + to_string(inexact) + " differ)");
+    check(worstTight < 1e-9, "a window around the score gives the score");
+
+    cout << endl << "RESULTS: " << passed << "/" << total << " tests passed" << endl;
+    return passed == total ? 0 : 1;
+}
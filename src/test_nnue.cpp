@@ -0,0 +1,117 @@
+#include "game.hpp"
+#include "evaluation.hpp"
+#include "nnue.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+struct NnueStats {
+    int nodes = 0;
+    int accumulatorMismatches = 0;
+    int kernelMismatches = 0;
+};
+
+static bool sameAccumulator(const NnueAccumulator& a, const NnueAccumulator& b) {
+    return memcmp(a.values, b.values, sizeof(a.values)) == 0;
+}
+
+// Compare the game's incremental accumulator against a fresh refresh, and the
+// SIMD output against the scalar reference, at every node of a small tree
+static void walk(ChessGame& game, const NnueNetwork& net, int depth, NnueStats& stats) {
+    NnueAccumulator fresh;
+    net.refresh(board, fresh);
+    const NnueAccumulator* acc = game.getNnueAccumulator();
+    stats.nodes++;
+    if (!acc || !sameAccumulator(*acc, fresh)) stats.accumulatorMismatches++;
+    if (net.evaluate(fresh, game.isWhiteToMove()) != net.evaluateScalar(fresh, game.isWhiteToMove())) {
+        stats.kernelMismatches++;
+    }
+    if (depth == 0) return;
+
+    for (const Move& move : game.getLegalMoves()) {
+        game.makeMoveForEngine(move);
+        walk(game, net, depth - 1, stats);
+        game.undoMove();
+    }
+}
+
+int main() {
+    cout << "=== NNUE TEST (kernels: " << NnueNetwork::simdName() << ") ===" << endl << endl;
+
+    NnueNetwork net;
+    net.randomize(12345);
+
+    struct WalkCase {
+        string fen;
+        int depth;
+        string description;
+    };
+    vector<WalkCase> cases = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3, "Starting position"},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 2, "Castling both sides"},
+        {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", 3, "En passant"},
+        {"r3k3/1P6/8/8/8/8/6p1/4K2R b K - 0 1", 3, "Promotions and captures with promotion"},
+    };
+
+    int passed = 0;
+    int total = 0;
+    for (const WalkCase& tc : cases) {
+        ChessGame game;
+        game.loadFEN(tc.fen);
+        game.attachNnue(&net);
+        NnueStats stats;
+        walk(game, net, tc.depth, stats);
+        bool ok = stats.accumulatorMismatches == 0 && stats.kernelMismatches == 0;
+        cout << (ok ? "PASS " : "FAIL ") << tc.description << ": " << stats.nodes << " nodes, "
+             << stats.accumulatorMismatches << " accumulator mismatches, "
+             << stats.kernelMismatches << " kernel mismatches" << endl;
+        total++;
+        if (ok) passed++;
+    }
+
+    // Weights survive a save/load round trip
+    {
+        string path = "test_nnue_weights.bin";
+        NnueNetwork loaded;
+        bool ok = net.save(path) && loaded.load(path);
+        ChessGame game;
+        game.loadFEN(cases[1].fen);
+        NnueAccumulator a, b;
+        net.refresh(board, a);
+        loaded.refresh(board, b);
+        ok = ok && sameAccumulator(a, b) && net.evaluate(a, true) == loaded.evaluate(b, true);
+        remove(path.c_str());
+        cout << (ok ? "PASS " : "FAIL ") << "Save/load round trip" << endl;
+        total++;
+        if (ok) passed++;
+    }
+
+    // A file that isn't a network is rejected
+    {
+        NnueNetwork other;
+        bool ok = !other.load("does_not_exist.nnue");
+        cout << (ok ? "PASS " : "FAIL ") << "Missing weight file rejected" << endl;
+        total++;
+        if (ok) passed++;
+    }
+
+    // NnueEvaluation gives the same score with and without an attached accumulator
+    {
+        NnueEvaluation eval(net);
+        ChessGame attached, detached;
+        attached.loadFEN(cases[1].fen);
+        detached.loadFEN(cases[1].fen);
+        attached.attachNnue(&net);
+        double a = eval.evaluate(attached);
+        double d = eval.evaluate(detached);
+        bool ok = a == d;
+        cout << (ok ? "PASS " : "FAIL ") << "NnueEvaluation incremental vs refresh: " << a << " / " << d << endl;
+        total++;
+        if (ok) passed++;
+    }
+
+    cout << endl << "RESULTS: " << passed << "/" << total << " tests passed" << endl;
+    return passed == total ? 0 : 1;
+}
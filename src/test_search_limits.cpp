@@ -0,0 +1,113 @@
+#include "game.hpp"
+#include "engine.hpp"
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+using namespace std::chrono;
+
+// Returns true if 'move' is one of the legal moves in 'game'
+static bool isLegal(ChessGame& game, const Move& move) {
+    for (const Move& m : game.getLegalMoves()) {
+        if (m.startRow == move.startRow && m.startColumn == move.startColumn &&
+            m.targetRow == move.targetRow && m.targetColumn == move.targetColumn) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main() {
+    cout << "=== SEARCH LIMITS TEST ===" << endl << endl;
+    int failed = 0;
+    const string middlegame = "r1bqk2r/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R1BQK2R w KQkq - 0 8";
+
+    // Test 1: movetime is respected
+    {
+        ChessGame game;
+        game.loadFEN(middlegame);
+        Engine engine;
+        SearchLimits limits;
+        limits.movetimeMs = 300;
+        auto start = steady_clock::now();
+        Move move = engine.getBestMove(game, limits);
+        long long ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        cout << "movetime 300: " << ms << " ms, depth " << engine.getLastResult().depth
+             << ", move " << game.moveToString(move) << endl;
+        if (ms > 600 || !isLegal(game, move)) {
+            cout << "  FAIL" << endl;
+            failed++;
+        }
+    }
+
+    // Test 2: node budget is respected
+    {
+        ChessGame game;
+        game.loadFEN(middlegame);
+        Engine engine;
+        SearchLimits limits;
+        limits.nodes = 5000;
+        Move move = engine.getBestMove(game, limits);
+        cout << "nodes 5000: searched " << engine.getLastResult().nodes << ", move " << game.moveToString(move) << endl;
+        if (engine.getLastResult().nodes > 5000 || !isLegal(game, move)) {
+            cout << "  FAIL" << endl;
+            failed++;
+        }
+    }
+
+    // Test 3: infinite search returns promptly after stop() from another thread
+    {
+        ChessGame game;
+        game.loadFEN(middlegame);
+        Engine engine;
+        SearchLimits limits;
+        limits.infinite = true;
+        thread stopper([&engine]() {
+            this_thread::sleep_for(milliseconds(200));
+            engine.stop();
+        });
+        auto start = steady_clock::now();
+        Move move = engine.getBestMove(game, limits);
+        long long ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        stopper.join();
+        cout << "infinite + stop after 200: " << ms << " ms, move " << game.moveToString(move) << endl;
+        if (ms > 500 || !isLegal(game, move)) {
+            cout << "  FAIL" << endl;
+            failed++;
+        }
+    }
+
+    // Test 4: clock-based allocation uses a fraction of the remaining time
+    {
+        ChessGame game;
+        game.loadFEN(middlegame);
+        Engine engine;
+        SearchLimits limits;
+        limits.wtimeMs = 3000;
+        limits.btimeMs = 3000;
+        auto start = steady_clock::now();
+        Move move = engine.getBestMove(game, limits);
+        long long ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        cout << "wtime 3000: " << ms << " ms, depth " << engine.getLastResult().depth << endl;
+        if (ms > 1200 || !isLegal(game, move)) {
+            cout << "  FAIL" << endl;
+            failed++;
+        }
+    }
+
+    // Test 5: fixed depth still completes every iteration
+    {
+        ChessGame game;
+        Engine engine;
+        engine.getBestMove(game, 3);
+        cout << "depth 3: completed depth " << engine.getLastResult().depth << endl;
+        if (engine.getLastResult().depth != 3) {
+            cout << "  FAIL" << endl;
+            failed++;
+        }
+    }
+
+    cout << endl << (failed == 0 ? "SUCCESS: all limits respected" : "FAILURES detected") << endl;
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+// Built with ENGINE_SEARCH_STATS defined (see CMakeLists.txt) so the engine
+// records into the attached SearchStats.
+#include "game.hpp"
+#include "engine.hpp"
+#include "searchStats.hpp"
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+static uint64_t sumOf(const SearchStats& stats, uint64_t DepthStats::*field) {
+    uint64_t sum = 0;
+    for (const DepthStats& d : stats.depths) sum += d.*field;
+    return sum;
+}
+
+int main() {
+    cout << "=== SEARCH STATS TEST ===" << endl << endl;
+
+#ifndef ENGINE_SEARCH_STATS
+    cout << "FAIL built without ENGINE_SEARCH_STATS" << endl;
+    return 1;
+#else
+    const char* fens[] = {
+        "r1bqk2r/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R1BQK2R w KQkq - 0 8",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "2r3k1/pp3ppp/2n1b3/3p4/3P4/2PB1N2/P4PPP/R5K1 w - - 0 1",
+    };
+    const double ZERO_WINDOW = 0.001;  // as in BasicEngine
+    int passed = 0;
+    int total = 0;
+    auto check = [&](bool ok, const string& what) {
+        cout << (ok ? "PASS " : "FAIL ") << what << endl;
+        total++;
+        if (ok) passed++;
+    };
+
+    // Every node below a zero-window root is a zero-window node, wherever the
+    // window sits: alpha + ZERO_WINDOW - alpha is not exactly ZERO_WINDOW
+    {
+        mt19937 rng(34);
+        uint64_t nodes = 0, nonPv = 0;
+        for (const char* fen : fens) {
+            for (int i = 0; i < 8; i++) {
+                ChessGame game;
+                game.loadFEN(fen);
+                Engine engine(16);
+                SearchStats stats;
+                engine.setSearchStats(&stats);
+                double alpha = uniform_real_distribution<double>(-5.0, 5.0)(rng);
+                engine.searchWindow(game, 4, alpha, alpha + ZERO_WINDOW);
+                nodes += sumOf(stats, &DepthStats::nodes);
+                nonPv += sumOf(stats, &DepthStats::nonPvNodes);
+            }
+        }
+        check(nodes > 0 && nonPv == nodes, "zero-window search: " + to_string(nonPv) + " of " + to_string(nodes) +
+                                               " nodes non-PV");
+    }
+
+    // A full search has both kinds
+    {
+        ChessGame game;
+        game.loadFEN(fens[2]);
+        Engine engine(16);
+        SearchStats stats;
+        engine.setSearchStats(&stats);
+        engine.getBestMove(game, 6);
+        uint64_t nodes = sumOf(stats, &DepthStats::nodes);
+        uint64_t nonPv = sumOf(stats, &DepthStats::nonPvNodes);
+        cout << "INFO " << stats.toJson() << endl;
+        check(nonPv > 0 && nonPv < nodes, "full search: " + to_string(nonPv) + " of " + to_string(nodes) +
+                                              " nodes non-PV");
+    }
+
+    cout << endl << "RESULTS: " << passed << "/" << total << " tests passed" << endl;
+    return passed == total ? 0 : 1;
+#endif
+}
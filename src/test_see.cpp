@@ -0,0 +1,45 @@
+#include "game.hpp"
+#include "moveGeneration.hpp"
+#include <iostream>
+#include <cmath>
+
+using namespace std;
+
+struct SeeCase {
+    string fen;
+    string move;      // coordinate notation, e.g. "e4d5"
+    double expected;  // material result in pawns for the side to move
+    string description;
+};
+
+int main() {
+    cout << "=== STATIC EXCHANGE EVALUATION TEST ===" << endl << endl;
+
+    vector<SeeCase> cases = {
+        {"4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1", "e4d5", 1.0, "Pawn takes undefended pawn"},
+        {"4k3/8/4p3/3p4/4P3/8/8/4K3 w - - 0 1", "e4d5", 0.0, "Pawn takes defended pawn (PxP, PxP)"},
+        {"4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1", "d1d5", -8.0, "Queen takes pawn defended by pawn"},
+        {"4k3/8/1n6/3p4/8/8/8/3RK3 w - - 0 1", "d1d5", -4.0, "Rook takes pawn defended by knight"},
+        {"3rk3/8/8/3p4/8/8/3R4/3RK3 w - - 0 1", "d2d5", 1.0, "Doubled rooks win a rook-defended pawn (x-ray)"},
+        {"3rk3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 1", "d2d5", -4.0, "Defended by doubled rooks: RxP, RxR, RxR, RxR"},
+        {"4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1", "d1d5", 9.0, "Rook takes hanging queen"},
+        {"4k3/8/8/3qK3/8/8/8/8 w - - 0 1", "e5d5", 9.0, "King takes undefended queen"},
+        {"4k3/8/4p3/3n4/2B5/8/8/4K3 w - - 0 1", "c4d5", 0.0, "Bishop takes knight defended by pawn"},
+        {"3qk3/8/8/3n4/4P3/8/8/3RK3 w - - 0 1", "e4d5", 3.0, "Queen declines to recapture a rook-defended pawn"},
+    };
+
+    int passed = 0;
+    for (const SeeCase& tc : cases) {
+        ChessGame game;
+        game.loadFEN(tc.fen);
+        Move move = game.parseMove(tc.move);
+        double see = staticExchangeEval(move);
+        bool ok = std::abs(see - tc.expected) < 1e-9;
+        cout << (ok ? "PASS " : "FAIL ") << tc.description << ": SEE(" << tc.move << ") = "
+             << see << " (expected " << tc.expected << ")" << endl;
+        if (ok) passed++;
+    }
+
+    cout << endl << "RESULTS: " << passed << "/" << cases.size() << " tests passed" << endl;
+    return passed == (int)cases.size() ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+#include "game.hpp"
+#include "engine.hpp"
+#include "evaluation.hpp"
+#include "endgame.hpp"
+#include "tablebase.hpp"
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+static string fenOf(const TablebasePosition& pos) {
+    int b[8][8] = {};
+    for (int i = 0; i < pos.count; i++) b[7 - pos.square[i] / 8][pos.square[i] % 8] = pos.piece[i];
+    string placement;
+    for (int row = 0; row < 8; row++) {
+        int empty = 0;
+        for (int col = 0; col < 8; col++) {
+            if (!b[row][col]) { empty++; continue; }
+            if (empty) placement += char('0' + empty);
+            empty = 0;
+            placement += pieceToChar(b[row][col]);
+        }
+        if (empty) placement += char('0' + empty);
+        if (row < 7) placement += '/';
+    }
+    return placement + (pos.whiteToMove ? " w - - 0 1" : " b - - 0 1");
+}
+
+// Random placement of 'pieces' (kings first); false if squares collide,
+// the kings touch, a pawn is on a back rank or the side not to move is in check
+static bool randomPosition(mt19937& rng, const vector<int>& pieces, TablebasePosition& pos, ChessGame& game) {
+    pos.count = static_cast<int>(pieces.size());
+    pos.whiteToMove = rng() % 2;
+    for (int i = 0; i < pos.count; i++) {
+        pos.piece[i] = pieces[i];
+        pos.square[i] = rng() % 64;
+        if ((pieces[i] & 7) == 1 && (pos.square[i] < 8 || pos.square[i] >= 56)) return false;
+        for (int j = 0; j < i; j++) {
+            if (pos.square[j] == pos.square[i]) return false;
+        }
+    }
+    if (max(abs(pos.square[0] / 8 - pos.square[1] / 8), abs(pos.square[0] % 8 - pos.square[1] % 8)) <= 1) return false;
+    game.loadFEN(fenOf(pos));
+    return !isKingInCheck(!pos.whiteToMove);
+}
+
+int main() {
+    cout << "=== TABLEBASE TEST ===" << endl << endl;
+
+    const string dir = "test_tablebase.tmp";
+    std::filesystem::remove_all(dir);
+    int passed = 0;
+    int total = 0;
+    auto check = [&](bool ok, const string& what) {
+        cout << (ok ? "PASS " : "FAIL ") << what << endl;
+        total++;
+        if (ok) passed++;
+    };
+
+    // Signatures
+    {
+        bool ok = canonicalSignature("KRKQ") == "KQKR" && canonicalSignature("KPKR") == "KRKP" &&
+                  canonicalSignature("KBKN") == "KBKN" && canonicalSignature("KNKB") == "KBKN" &&
+                  canonicalSignature("KQRKRP") == "" && canonicalSignature("KXK") == "";
+        ok &= allSignatures(3).size() == 5 && allSignatures(4).size() == 35 && allSignatures(5).size() == 145;
+        check(ok, "canonical signatures and table counts");
+    }
+
+    // Generation (KPK pulls in KQK, KRK, KBK, KNK)
+    Tablebase tables;
+    {
+        bool ok = generateTablebase(dir, "KPK", tables, &cout) && tables.tableCount() == 5 && tables.maxPieces() == 3;
+        Tablebase reloaded;
+        ok &= reloaded.load(dir) == 5;
+        check(ok, "generate and map KPK with its subtables");
+    }
+
+    // Longest mates: KQK 10 moves, KRK 16
+    {
+        int longest[2] = {0, 0};
+        const int attackers[2] = {WHITE_QUEEN, WHITE_ROOK};
+        for (int t = 0; t < 2; t++) {
+            TablebasePosition pos;
+            pos.count = 3;
+            pos.piece[0] = WHITE_KING;
+            pos.piece[1] = BLACK_KING;
+            pos.piece[2] = attackers[t];
+            for (int idx = 0; idx < 64 * 64 * 64; idx++) {
+                pos.square[0] = idx % 64;
+                pos.square[1] = idx / 64 % 64;
+                pos.square[2] = idx / 4096;
+                TablebaseValue value;
+                if (tables.probe(pos, value) && value.wdl > 0) longest[t] = max(longest[t], value.plies);
+            }
+        }
+        check(longest[0] == 19 && longest[1] == 31, "longest mates KQK " + to_string((longest[0] + 1) / 2) +
+                                                        ", KRK " + to_string((longest[1] + 1) / 2) + " moves");
+    }
+
+    // Every probed value follows from its children through the real move
+    // generator, for both colours (the reversed ones probe mirrored)
+    {
+        mt19937 rng(5);
+        ChessGame game;
+        const vector<vector<int>> materials = {
+            {WHITE_KING, BLACK_KING, WHITE_ROOK}, {WHITE_KING, BLACK_KING, BLACK_QUEEN},
+            {WHITE_KING, BLACK_KING, WHITE_PAWN}, {WHITE_KING, BLACK_KING, BLACK_PAWN}};
+        int tested = 0, mismatches = 0;
+        while (tested < 4000) {
+            TablebasePosition pos;
+            if (!randomPosition(rng, materials[tested % materials.size()], pos, game)) continue;
+            TablebaseValue value;
+            if (!tables.probe(game, value)) { mismatches++; tested++; continue; }
+
+            TablebaseValue expected;
+            vector<Move> moves = game.getLegalMoves();
+            if (moves.empty()) {
+                expected.wdl = game.isInCheck() ? -1 : 0;
+            } else {
+                int best = -1000000;
+                for (const Move& m : moves) {
+                    game.makeMoveForEngine(m);
+                    TablebaseValue child;
+                    bool found = tables.probe(game, child);
+                    game.undoMove();
+                    if (!found) { best = 1000001; break; }
+                    int rank = child.wdl < 0 ? 100000 - child.plies : (child.wdl > 0 ? -100000 + child.plies : 0);
+                    if (rank > best) {
+                        best = rank;
+                        expected.wdl = -child.wdl;
+                        expected.plies = child.wdl ? child.plies + 1 : 0;
+                    }
+                }
+                if (best == 1000001) expected.wdl = 2;  // child not probed: always a mismatch
+            }
+            if (expected.wdl != value.wdl || expected.plies != value.plies) mismatches++;
+            tested++;
+        }
+        check(mismatches == 0, "values consistent with move generation (" + to_string(tested) + " positions, " +
+                                   to_string(mismatches) + " mismatches)");
+    }
+
+    // WDL agrees with the KPK bitbase
+    {
+        mt19937 rng(9);
+        ChessGame game;
+        int tested = 0, mismatches = 0;
+        while (tested < 20000) {
+            TablebasePosition pos;
+            vector<int> pieces = {WHITE_KING, BLACK_KING, rng() % 2 ? WHITE_PAWN : BLACK_PAWN};
+            if (!randomPosition(rng, pieces, pos, game)) continue;
+            TablebaseValue value;
+            tables.probe(game, value);
+            bool pawnSideToMove = game.isWhiteToMove() == (pieces[2] == WHITE_PAWN);
+            bool pawnSideWins = value.wdl == (pawnSideToMove ? 1 : -1);
+            if (pawnSideWins != kpkIsWin(board, game.isWhiteToMove())) mismatches++;
+            tested++;
+        }
+        check(mismatches == 0, "KPK agrees with the bitbase (" + to_string(tested) + " positions, " +
+                                   to_string(mismatches) + " mismatches)");
+    }
+
+    // The engine plays KRK by the table: mate in exactly the announced moves
+    {
+        Evaluation eval;
+        Engine engine(eval, 16);
+        engine.setTablebase(&tables);
+        ChessGame game;
+        game.loadFEN("8/8/3k4/8/8/8/8/R3K3 w - - 0 1");
+        TablebaseValue start;
+        tables.probe(game, start);
+        int plies = 0;
+        bool consistent = true;
+        while (!game.getLegalMoves().empty() && plies < 100) {
+            Move move = engine.getBestMove(game, 1);
+            consistent &= engine.getLastResult().tbHits > 0;
+            game.makeEngineMove(move);
+            plies++;
+        }
+        bool ok = start.wdl == 1 && game.isInCheckmate() && plies == start.plies && consistent;
+        check(ok, "engine mates KRK in " + to_string((start.plies + 1) / 2) + " moves from the table (took " +
+                      to_string((plies + 1) / 2) + ")");
+    }
+
+    // Probed below the root: winning a knight converts to a KRK mate score
+    {
+        Evaluation eval;
+        Engine engine(eval, 16);
+        engine.setTablebase(&tables);
+        ChessGame game;
+        game.loadFEN("n3k3/8/8/8/R7/8/8/4K3 w - - 0 1");
+        Move move = engine.getBestMove(game, 3);
+        const SearchResult& r = engine.getLastResult();
+        bool ok = move.startRow == 4 && move.startColumn == 0 && move.targetRow == 0 && move.targetColumn == 0 &&
+                  r.score > 99000.0 && r.tbHits > 0;
+        cout << "INFO score " << r.score << ", tbhits " << r.tbHits << endl;
+        check(ok, "search finds Rxa8 into a tablebase mate");
+    }
+
+    // A damaged file is refused
+    {
+        std::filesystem::copy_file(dir + "/KRK.ctb", dir + "/KRK.bad", std::filesystem::copy_options::overwrite_existing);
+        std::filesystem::resize_file(dir + "/KRK.bad", 1000);
+        std::filesystem::create_directory(dir + "/bad");
+        std::filesystem::rename(dir + "/KRK.bad", dir + "/bad/KRK.ctb");
+        Tablebase damaged;
+        check(!damaged.loadFile(dir + "/bad/KRK.ctb") && damaged.load(dir + "/bad") == 0, "truncated table rejected");
+    }
+
+    tables.clear();
+    std::filesystem::remove_all(dir);
+    cout << endl << "RESULTS: " << passed << "/" << total << " tests passed" << endl;
+    return passed == total ? 0 : 1;
+}
@@ -0,0 +1,445 @@
+// Texel-style tuner: fits the evaluation parameters (evalParams.hpp) to game
+// results of stored quiet positions by minimising
+//     E = mean (result - sigmoid(K * eval))^2
+// with Adam over full-batch gradients computed on all cores.
+//
+// Dataset: one position per line, a FEN followed by the game result as
+// "1-0", "0-1", "1/2-1/2" or a number (1.0 / 0.5 / 0.0), e.g.
+//     rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - c9 "1/2-1/2";
+// Positions in check, known endings (endgame.hpp) and lines without a
+// result are skipped. Results are from white's point of view.
+//
+// Each position is reduced once to a trace: the counts every linear
+// parameter is multiplied by (material, PST squares, mobility, threats),
+// the king-zone hits for the quadratic king-attack term, and the terms that
+// aren't tuned (king shelter, pawn structure) as a constant.
+
+#include "game.hpp"
+#include "evaluation.hpp"
+#include "evalParams.hpp"
+#include "positionBatch.hpp"
+#include "endgame.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Flat view of EvalParams: every value gets an index into the parameter vector
+struct ParamLayout {
+    int total = 0;
+    int material = 0, pstMg = 0, pstEg = 0, mobility = 0, kingUnits = 0, kingMax = 0;
+    int hangingPawn = 0, hangingPiece = 0, threatByPawn = 0, threatByMinor = 0, threatByRook = 0;
+    vector<bool> tunable;
+
+    ParamLayout() {
+        EvalParams p{};
+        forEachParam(p, [&](const char* name, int*, int count, bool tune) {
+            int offset = total;
+            string n = name;
+            if (n == "material") material = offset;
+            else if (n == "pst_mg") pstMg = offset;
+            else if (n == "pst_eg") pstEg = offset;
+            else if (n == "mobility_weight") mobility = offset;
+            else if (n == "king_attack_units") kingUnits = offset;
+            else if (n == "king_attack_max") kingMax = offset;
+            else if (n == "hanging_pawn") hangingPawn = offset;
+            else if (n == "hanging_piece") hangingPiece = offset;
+            else if (n == "threat_by_pawn") threatByPawn = offset;
+            else if (n == "threat_by_minor") threatByMinor = offset;
+            else if (n == "threat_by_rook") threatByRook = offset;
+            total += count;
+            tunable.insert(tunable.end(), count, tune);
+        });
+    }
+};
+
+static vector<double> toVector(const EvalParams& params) {
+    EvalParams p = params;
+    vector<double> v;
+    forEachParam(p, [&](const char*, int* values, int count, bool) { v.insert(v.end(), values, values + count); });
+    return v;
+}
+
+static EvalParams fromVector(const vector<double>& v) {
+    EvalParams p = defaultEvalParams();
+    size_t i = 0;
+    forEachParam(p, [&](const char*, int* values, int count, bool) {
+        for (int k = 0; k < count; k++) values[k] = static_cast<int>(lround(v[i++]));
+    });
+    return p;
+}
+
+// Linear term: 'coef' times parameter 'param'. PST terms name the
+// middlegame entry and imply the matching endgame one.
+struct Term {
+    uint16_t param;
+    int16_t coef;
+};
+
+struct Trace {
+    float result;
+    float fixed;            // untuned terms, pawns
+    uint8_t phase;          // 0..PHASE_MAX
+    uint8_t kingHits[2][7]; // king-zone squares hit, by attacking type, per defending side
+    uint8_t kingAttackers[2];
+    uint32_t firstTerm;
+    uint16_t termCount;
+};
+
+// Exposes the untuned terms
+class TexelEvaluation : public Evaluation {
+public:
+    double untunedTerms(const ChessGame& game) const { return 0.01*kingsafety(game) + 0.01*pawnStructure(game); }
+};
+
+struct Dataset {
+    vector<Trace> traces;
+    vector<Term> terms;
+    vector<PackedPosition> positions;  // kept for the consistency check
+};
+
+static bool isNumber(const string& s) {
+    return !s.empty() && all_of(s.begin(), s.end(), [](char c) { return isdigit(static_cast<unsigned char>(c)); });
+}
+
+// Splits a dataset line into the FEN (four fields, plus the move counters
+// when both are present) and whatever follows it
+static bool splitLine(const string& line, string& fen, string& rest) {
+    istringstream in(line);
+    vector<string> fields;
+    string field;
+    while (in >> field) fields.push_back(field);
+    if (fields.size() < 4) return false;
+    size_t count = fields.size() >= 6 && isNumber(fields[4]) && isNumber(fields[5]) ? 6 : 4;
+    fen.clear();
+    rest.clear();
+    for (size_t i = 0; i < fields.size(); i++) {
+        string& target = i < count ? fen : rest;
+        target += (target.empty() ? "" : " ") + fields[i];
+    }
+    return true;
+}
+
+// Result from the text after the FEN; false if there is none
+static bool parseResult(const string& text, float& result) {
+    if (text.empty()) return false;
+    if (text.find("1/2-1/2") != string::npos) { result = 0.5f; return true; }
+    if (text.find("1-0") != string::npos) { result = 1.0f; return true; }
+    if (text.find("0-1") != string::npos) { result = 0.0f; return true; }
+    // Trailing number, possibly wrapped in [] or quotes
+    string tail = text.substr(text.find_last_of(' ') + 1);
+    tail.erase(remove_if(tail.begin(), tail.end(), [](char c) { return c == '[' || c == ']' || c == '"' || c == ';'; }), tail.end());
+    char* end = nullptr;
+    double value = strtod(tail.c_str(), &end);
+    if (end == tail.c_str() || value < 0.0 || value > 1.0) return false;
+    result = static_cast<float>(value);
+    return true;
+}
+
+static void addTrace(Dataset& data, const ParamLayout& layout, const ChessGame& game, float result, const TexelEvaluation& eval) {
+    const EvalParams& params = evalParams();
+    Trace t{};
+    t.result = result;
+    t.fixed = static_cast<float>(eval.untunedTerms(game));
+    t.firstTerm = static_cast<uint32_t>(data.terms.size());
+
+    auto add = [&](int param, int coef) {
+        if (coef != 0) data.terms.push_back({static_cast<uint16_t>(param), static_cast<int16_t>(coef)});
+    };
+
+    // Material and PST
+    int materialCount[7] = {};
+    int phase = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        int piece = board[sq / 8][sq % 8];
+        int type = piece & 0b0111;
+        if (piece == EMPTY || type > 6) continue;
+        bool white = isWhite(piece);
+        materialCount[type] += white ? 1 : -1;
+        int pstSquare = (white ? sq / 8 : 7 - sq / 8) * 8 + sq % 8;
+        add(layout.pstMg + type * 64 + pstSquare, white ? 1 : -1);
+        phase += PHASE_WEIGHT[type];
+    }
+    for (int type = 1; type < 6; type++) add(layout.material + type, materialCount[type]);
+    t.phase = static_cast<uint8_t>(min(phase, PHASE_MAX));
+
+    // Attack-map terms, counted the way Evaluation::mobility/kingAttack/threats weigh them
+    AttackMaps maps;
+    computeAttackMaps(board, maps);
+    int mobility[7] = {};
+    int hangingPawn = 0, hangingPiece = 0, byPawn = 0, byMinor = 0, byRook = 0;
+    for (int c = 0; c < 2; c++) {
+        int sign = c == 0 ? 1 : -1;  // mobility is a bonus, threats a penalty
+        int enemy = c ^ 1;
+        Bitboard area = ~maps.pieces[c][0] & ~maps.attacks[enemy][1];
+        for (int i = 0; i < maps.count[c]; i++) {
+            const PieceAttacks& p = maps.list[c][i];
+            mobility[p.type] += sign * (popCount(p.attacks & area) - params.mobilityBaseline[p.type]);
+        }
+
+        Bitboard zone = maps.kingSquare[c] >= 0 ? kingAttacks(maps.kingSquare[c]) | squareBit(maps.kingSquare[c]) : 0;
+        for (int i = 0; i < maps.count[enemy]; i++) {
+            const PieceAttacks& p = maps.list[enemy][i];
+            int hits = popCount(p.attacks & zone);
+            if (hits == 0) continue;
+            t.kingAttackers[c]++;
+            t.kingHits[c][p.type] = static_cast<uint8_t>(t.kingHits[c][p.type] + hits);
+        }
+
+        Bitboard attacked = maps.attacks[enemy][0];
+        Bitboard undefended = ~maps.attacks[c][0];
+        Bitboard pieces = maps.pieces[c][2] | maps.pieces[c][3] | maps.pieces[c][4] | maps.pieces[c][5];
+        Bitboard minorAttacks = maps.attacks[enemy][3] | maps.attacks[enemy][4];
+        hangingPawn -= sign * popCount(maps.pieces[c][1] & attacked & undefended);
+        hangingPiece -= sign * popCount(pieces & attacked & undefended);
+        byPawn -= sign * popCount(pieces & maps.attacks[enemy][1]);
+        byMinor -= sign * popCount((maps.pieces[c][2] | maps.pieces[c][5]) & minorAttacks);
+        byRook -= sign * popCount(maps.pieces[c][5] & maps.attacks[enemy][2]);
+    }
+    for (int type = 1; type < 7; type++) add(layout.mobility + type, mobility[type]);
+    add(layout.hangingPawn, hangingPawn);
+    add(layout.hangingPiece, hangingPiece);
+    add(layout.threatByPawn, byPawn);
+    add(layout.threatByMinor, byMinor);
+    add(layout.threatByRook, byRook);
+
+    t.termCount = static_cast<uint16_t>(data.terms.size() - t.firstTerm);
+    data.traces.push_back(t);
+}
+
+static bool loadDataset(const string& path, size_t limit, const ParamLayout& layout, Dataset& data) {
+    ifstream in(path);
+    if (!in) return false;
+    TexelEvaluation eval;
+    ChessGame game;
+    string line;
+    size_t skipped = 0;
+    while (getline(in, line) && data.traces.size() < limit) {
+        if (line.empty()) continue;
+        float result;
+        string fen, rest;
+        if (!splitLine(line, fen, rest) || !parseResult(rest, result)) { skipped++; continue; }
+        game.loadFEN(fen);
+        // Known endings aren't scored by the tuned terms (endgame.hpp)
+        if (game.isInCheck() || findEndgame(game.getMaterialKey())) { skipped++; continue; }
+        addTrace(data, layout, game, result, eval);
+        data.positions.push_back(PackedPosition::fromBoard(board, game.isWhiteToMove()));
+    }
+    cout << "Loaded " << data.traces.size() << " positions (" << skipped << " skipped)" << endl;
+    return !data.traces.empty();
+}
+
+static bool isMaterial(const ParamLayout& layout, int param) { return param >= layout.material && param < layout.material + 7; }
+
+// Mobility, king attack and threats of one trace in pawns, before the clamp
+// Evaluation::activity applies
+static double traceActivity(const Trace& t, const Term* terms, const ParamLayout& layout, const vector<double>& theta) {
+    double linear = 0.0;
+    for (int i = 0; i < t.termCount; i++) {
+        const Term& term = terms[i];
+        if (term.param >= layout.pstMg && term.param < layout.pstEg) continue;
+        if (!isMaterial(layout, term.param)) linear += term.coef * theta[term.param];
+    }
+    double king = 0.0;
+    for (int c = 0; c < 2; c++) {
+        if (t.kingAttackers[c] < 2) continue;
+        double units = 0.0;
+        for (int type = 1; type < 7; type++) units += theta[layout.kingUnits + type] * t.kingHits[c][type];
+        double penalty = min(theta[layout.kingMax], units * units / 4.0);
+        king += c == 0 ? -penalty : penalty;
+    }
+    return 0.01 * (linear + king);
+}
+
+// Evaluation of one trace with parameters 'theta' (pawns, white positive)
+static double traceEval(const Trace& t, const Term* terms, const ParamLayout& layout, const vector<double>& theta) {
+    double mg = 0.0, eg = 0.0, material = 0.0;
+    for (int i = 0; i < t.termCount; i++) {
+        const Term& term = terms[i];
+        if (term.param >= layout.pstMg && term.param < layout.pstEg) {
+            mg += term.coef * theta[term.param];
+            eg += term.coef * theta[term.param + (layout.pstEg - layout.pstMg)];
+        } else if (isMaterial(layout, term.param)) {
+            material += term.coef * theta[term.param];
+        }
+    }
+    double pst = (mg * t.phase + eg * (PHASE_MAX - t.phase)) / PHASE_MAX;
+    const double margin = Evaluation::LAZY_ACTIVITY_MARGIN;
+    double activity = clamp(traceActivity(t, terms, layout, theta), -margin, margin);
+    // Material is in centipawns, PSTs in 1/100 centipawn (see Evaluation::position)
+    return 0.01 * material + activity + 0.0001 * pst + t.fixed;
+}
+
+static double sigmoid(double eval, double k) { return 1.0 / (1.0 + pow(10.0, -k * eval / 4.0)); }
+
+// Runs fn(begin, end, threadIndex) over the dataset on 'threads' threads
+template <class F>
+static void parallelFor(size_t n, int threads, F fn) {
+    vector<thread> pool;
+    size_t per = (n + threads - 1) / threads;
+    for (int i = 0; i < threads; i++) {
+        size_t begin = i * per, end = min(n, begin + per);
+        if (begin >= end) break;
+        pool.emplace_back(fn, begin, end, i);
+    }
+    for (thread& t : pool) t.join();
+}
+
+static double meanError(const Dataset& data, const ParamLayout& layout, const vector<double>& theta, double k, int threads) {
+    vector<double> sums(threads, 0.0);
+    parallelFor(data.traces.size(), threads, [&](size_t begin, size_t end, int id) {
+        double sum = 0.0;
+        for (size_t i = begin; i < end; i++) {
+            const Trace& t = data.traces[i];
+            double diff = t.result - sigmoid(traceEval(t, &data.terms[t.firstTerm], layout, theta), k);
+            sum += diff * diff;
+        }
+        sums[id] = sum;
+    });
+    double total = 0.0;
+    for (double s : sums) total += s;
+    return total / data.traces.size();
+}
+
+static vector<double> gradient(const Dataset& data, const ParamLayout& layout, const vector<double>& theta, double k, int threads) {
+    vector<vector<double>> partial(threads, vector<double>(layout.total, 0.0));
+    parallelFor(data.traces.size(), threads, [&](size_t begin, size_t end, int id) {
+        vector<double>& grad = partial[id];
+        const double slope = log(10.0) * k / 4.0;
+        for (size_t i = begin; i < end; i++) {
+            const Trace& t = data.traces[i];
+            const Term* terms = &data.terms[t.firstTerm];
+            double p = sigmoid(traceEval(t, terms, layout, theta), k);
+            // dE/d(eval) for this position
+            double g = -2.0 * (t.result - p) * slope * p * (1.0 - p);
+            // A clamped activity sum doesn't move with its parameters
+            bool clamped = fabs(traceActivity(t, terms, layout, theta)) > Evaluation::LAZY_ACTIVITY_MARGIN;
+
+            double mgWeight = 0.0001 * t.phase / PHASE_MAX;
+            double egWeight = 0.0001 * (PHASE_MAX - t.phase) / PHASE_MAX;
+            for (int j = 0; j < t.termCount; j++) {
+                const Term& term = terms[j];
+                if (term.param >= layout.pstMg && term.param < layout.pstEg) {
+                    grad[term.param] += g * term.coef * mgWeight;
+                    grad[term.param + (layout.pstEg - layout.pstMg)] += g * term.coef * egWeight;
+                } else if (!clamped || isMaterial(layout, term.param)) {
+                    grad[term.param] += g * term.coef * 0.01;
+                }
+            }
+            for (int c = 0; c < 2; c++) {
+                if (clamped || t.kingAttackers[c] < 2) continue;
+                double sign = c == 0 ? -0.01 : 0.01;
+                double units = 0.0;
+                for (int type = 1; type < 7; type++) units += theta[layout.kingUnits + type] * t.kingHits[c][type];
+                if (units * units / 4.0 < theta[layout.kingMax]) {
+                    for (int type = 1; type < 7; type++) grad[layout.kingUnits + type] += g * sign * units / 2.0 * t.kingHits[c][type];
+                } else {
+                    grad[layout.kingMax] += g * sign;
+                }
+            }
+        }
+    });
+    vector<double> grad(layout.total, 0.0);
+    for (const auto& part : partial) {
+        for (int i = 0; i < layout.total; i++) grad[i] += part[i];
+    }
+    for (double& x : grad) x /= data.traces.size();
+    return grad;
+}
+
+// Scaling constant K that best fits the current parameters (ternary search)
+static double fitK(const Dataset& data, const ParamLayout& layout, const vector<double>& theta, int threads) {
+    double lo = 0.05, hi = 5.0;
+    for (int i = 0; i < 40; i++) {
+        double a = lo + (hi - lo) / 3, b = hi - (hi - lo) / 3;
+        if (meanError(data, layout, theta, a, threads) < meanError(data, layout, theta, b, threads)) hi = b;
+        else lo = a;
+    }
+    return (lo + hi) / 2;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: chess_texel <dataset> [--epochs N] [--lr X] [--threads N] [--limit N] [--out FILE]\n";
+        return 1;
+    }
+    string datasetPath = argv[1];
+    int epochs = 500;
+    double learningRate = 1.0;  // centipawns per step
+    int threads = max(1u, thread::hardware_concurrency());
+    size_t limit = SIZE_MAX;
+    string outPath = "texel_params.txt";
+    for (int i = 2; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        if (flag == "--epochs") epochs = atoi(argv[i + 1]);
+        else if (flag == "--lr") learningRate = atof(argv[i + 1]);
+        else if (flag == "--threads") threads = max(1, atoi(argv[i + 1]));
+        else if (flag == "--limit") limit = strtoull(argv[i + 1], nullptr, 10);
+        else if (flag == "--out") outPath = argv[i + 1];
+        else { cout << "Unknown option " << flag << "\n"; return 1; }
+    }
+
+    ParamLayout layout;
+    Dataset data;
+    if (!loadDataset(datasetPath, limit, layout, data)) {
+        cout << "No positions loaded from " << datasetPath << "\n";
+        return 1;
+    }
+
+    vector<double> theta = toVector(evalParams());
+
+    // The traces must reproduce the engine's evaluation
+    {
+        size_t n = min<size_t>(data.positions.size(), 1000);
+        PositionBatch batch(vector<PackedPosition>(data.positions.begin(), data.positions.begin() + n));
+        vector<double> engineEval(n);
+        TexelEvaluation().evaluateBatch(batch, engineEval.data(), threads);
+        double worst = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            const Trace& t = data.traces[i];
+            double traced = traceEval(t, &data.terms[t.firstTerm], layout, theta);
+            worst = max(worst, fabs(traced - (engineEval[i] + t.fixed)));
+        }
+        cout << "Trace vs engine evaluation, max difference: " << worst << " pawns" << endl;
+        if (worst > 0.05) cout << "WARNING: traces disagree with Evaluation; the tuner is out of date" << endl;
+    }
+
+    double k = fitK(data, layout, theta, threads);
+    cout << "K = " << k << ", initial error = " << meanError(data, layout, theta, k, threads) << endl;
+
+    // Adam
+    const double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    vector<double> m(layout.total, 0.0), v(layout.total, 0.0);
+    auto start = chrono::steady_clock::now();
+    for (int epoch = 1; epoch <= epochs; epoch++) {
+        vector<double> grad = gradient(data, layout, theta, k, threads);
+        for (int i = 0; i < layout.total; i++) {
+            if (!layout.tunable[i]) continue;
+            m[i] = beta1 * m[i] + (1 - beta1) * grad[i];
+            v[i] = beta2 * v[i] + (1 - beta2) * grad[i] * grad[i];
+            double mHat = m[i] / (1 - pow(beta1, epoch));
+            double vHat = v[i] / (1 - pow(beta2, epoch));
+            theta[i] -= learningRate * mHat / (sqrt(vHat) + epsilon);
+        }
+        theta[layout.kingMax] = max(0.0, theta[layout.kingMax]);
+        if (epoch % 50 == 0 || epoch == epochs) {
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cout << "epoch " << epoch << "  error " << meanError(data, layout, theta, k, threads)
+                 << "  (" << seconds << " s)" << endl;
+        }
+    }
+
+    if (!saveEvalParams(outPath, fromVector(theta))) {
+        cout << "Cannot write " << outPath << "\n";
+        return 1;
+    }
+    cout << "Wrote " << outPath << endl;
+    return 0;
+}
@@ -1,5 +1,5 @@
 #include "game.hpp"
-#include "engine.hpp"
+#include "engine_impl.hpp"  // BasicEngine<TunableEvaluation>
 #include "evaluation.hpp"
 #include <iostream>
 #include <vector>
@@ -73,8 +73,8 @@ string playGame(EvalConfig& config1, EvalConfig& config2, bool config1PlaysWhite
     TunableEvaluation eval2(config2.materialWeight, config2.positionWeight, 
                             config2.kingSafetyWeight, config2.pawnStructureWeight);
     
-    Engine engine1(eval1);
-    Engine engine2(eval2);
+    BasicEngine<TunableEvaluation> engine1(eval1, Engine::SELFPLAY_HASH_MB);
+    BasicEngine<TunableEvaluation> engine2(eval2, Engine::SELFPLAY_HASH_MB);
     
     // Only play random opening moves if starting from standard position
     if (startingFen.empty() || startingFen == "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1") {
@@ -101,7 +101,7 @@ string playGame(EvalConfig& config1, EvalConfig& config2, bool config1PlaysWhite
         bool isWhiteTurn = game.isWhiteToMove();
         
         // Determine which engine plays
-        Engine* currentEngine = nullptr;
+        BasicEngine<TunableEvaluation>* currentEngine = nullptr;
         if ((isWhiteTurn && config1PlaysWhite) || (!isWhiteTurn && !config1PlaysWhite)) {
             currentEngine = &engine1;
         } else {
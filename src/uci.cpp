@@ -0,0 +1,353 @@
+// UCI protocol front-end: lets GUIs, tournament managers and analysis
+// pipelines drive the engine over stdin/stdout.
+#include "board.hpp"
+#include "game.hpp"
+#include "engine_impl.hpp"  // BasicEngine<NnueEvaluation>
+#include "evalParams.hpp"
+#include "nnue.hpp"
+#include "tablebase.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cmath>
+#include <algorithm>
+#include <memory>
+
+using namespace std;
+
+static const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+static const int DEFAULT_HASH_MB = static_cast<int>(Engine::DEFAULT_HASH_MB);
+static const int MAX_HASH_MB = 4096;
+
+using NnueEngine = BasicEngine<NnueEvaluation>;
+
+// All output goes through here so info lines from the search thread
+// never interleave with replies from the input thread.
+static mutex outputMutex;
+static void send(const string& line) {
+    lock_guard<mutex> lock(outputMutex);
+    cout << line << endl;
+}
+
+// Long algebraic notation used by UCI (e2e4, e7e8q, e1g1 for castling)
+static string moveToUci(const ChessGame& game, const Move& move) {
+    string s = game.coordinateToString(move.startRow, move.startColumn) +
+               game.coordinateToString(move.targetRow, move.targetColumn);
+    if (move.moveType == PAWN_PROMOTION) {
+        switch (move.promotionPiece & 0b0111) {
+            case 0b0101: s += 'q'; break;
+            case 0b0010: s += 'r'; break;
+            case 0b0100: s += 'b'; break;
+            case 0b0011: s += 'n'; break;
+        }
+    }
+    return s;
+}
+
+// Find the legal move matching a UCI move string; returns false if none does
+static bool parseUciMove(const ChessGame& game, const string& str, Move& out) {
+    for (const Move& m : game.getLegalMoves()) {
+        if (moveToUci(game, m) == str) {
+            out = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Scores are white-relative pawns; UCI wants side-to-move centipawns or mate in moves
+static string scoreToUci(double score, bool whiteToMove) {
+    const double MATE_SCORE = 100000.0;
+    double stm = whiteToMove ? score : -score;
+    if (std::abs(stm) >= MATE_SCORE - 1000.0) {
+        int plies = static_cast<int>(std::round(MATE_SCORE - std::abs(stm)));
+        int moves = (plies + 1) / 2;
+        return "mate " + to_string(stm > 0 ? moves : -moves);
+    }
+    return "cp " + to_string(static_cast<int>(std::round(stm * 100.0)));
+}
+
+class UciSession {
+private:
+    ChessGame game;
+    Engine engine;
+    Tablebase tablebase;
+    int hashMB = DEFAULT_HASH_MB;
+    bool largePages = false;
+    // NNUEFile network; nnueEngine exists while UseNNUE is on and one is loaded
+    NnueNetwork network;
+    bool networkLoaded = false;
+    bool useNnue = false;
+    unique_ptr<NnueEngine> nnueEngine;
+    thread searchThread;
+    atomic<bool> searchRunning{false};
+    atomic<bool> stopRequested{false};
+
+    void handleUci() {
+        send("id name Chess");
+        send("id author Kevin Cooreman");
+        send("option name Hash type spin default " + to_string(DEFAULT_HASH_MB) +
+             " min 1 max " + to_string(MAX_HASH_MB));
+        send("option name LargePages type check default false");
+        send("option name Threads type spin default 1 min 1 max 1");
+        send("option name EvalFile type string default <empty>");
+        send("option name TablebasePath type string default <empty>");
+        send("option name UseNNUE type check default false");
+        send("option name NNUEFile type string default <empty>");
+        send("uciok");
+    }
+
+    // Parameter file (see evalParams.hpp); empty or <empty> restores the defaults
+    void loadEvalFile(const string& path) {
+#ifdef EVAL_FROZEN_PARAMS
+        send("info string EvalFile ignored: evaluation parameters are compiled in");
+#else
+        EvalParams params = defaultEvalParams();
+        if (!path.empty() && path != "<empty>" && !loadEvalParams(path, params)) {
+            send("info string cannot load EvalFile " + path);
+            return;
+        }
+        setEvalParams(params);
+        // cached evaluations used the old parameters
+        engine.newGame();
+        if (nnueEngine) nnueEngine->newGame();
+#endif
+    }
+
+    // Directory of chess_tbgen tables; empty or <empty> turns probing off
+    void loadTablebases(const string& path) {
+        tablebase.clear();
+        if (path.empty() || path == "<empty>") return;
+        int loaded = tablebase.load(path);
+        if (loaded < 0) {
+            send("info string cannot read TablebasePath " + path);
+            return;
+        }
+        send("info string " + to_string(loaded) + " tablebases loaded, up to " +
+             to_string(tablebase.maxPieces()) + " pieces");
+    }
+
+    // Network weights (see nnue.hpp); empty or <empty> unloads the network
+    void loadNnueFile(const string& path) {
+        networkLoaded = false;
+        if (!path.empty() && path != "<empty>") {
+            networkLoaded = network.load(path);
+            send(networkLoaded ? "info string NNUE network loaded (" + string(NnueNetwork::simdName()) + ")"
+                               : "info string cannot load NNUEFile " + path);
+        }
+        updateNnue();
+    }
+
+    // Searches go to nnueEngine when UseNNUE is on and a network is loaded. The
+    // game carries the network's accumulators only then, and the idle classical
+    // engine keeps a minimal hash table meanwhile.
+    void updateNnue() {
+        // A new network invalidates everything the old engine cached
+        nnueEngine.reset();
+        game.attachNnue(nullptr);
+        if (useNnue && networkLoaded) {
+            engine.setHashSize(1);
+            nnueEngine = make_unique<NnueEngine>(NnueEvaluation(network), 1);
+            nnueEngine->setHashSize(static_cast<size_t>(hashMB), largePages);
+            nnueEngine->setInfoCallback([this](const SearchResult& r) { sendInfo(r); });
+            nnueEngine->setTablebase(&tablebase);
+            game.attachNnue(&network);
+        } else {
+            if (useNnue) send("info string UseNNUE needs an NNUEFile, using the classical evaluation");
+            engine.setHashSize(static_cast<size_t>(hashMB), largePages);
+        }
+    }
+
+    void resizeHash() {
+        if (nnueEngine) nnueEngine->setHashSize(static_cast<size_t>(hashMB), largePages);
+        else engine.setHashSize(static_cast<size_t>(hashMB), largePages);
+    }
+
+    void handleSetOption(istringstream& in) {
+        string token, name, value;
+        bool readingValue = false;
+        while (in >> token) {
+            if (token == "name") { readingValue = false; continue; }
+            if (token == "value") { readingValue = true; continue; }
+            string& target = readingValue ? value : name;
+            if (!target.empty()) target += ' ';
+            target += token;
+        }
+        transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+        if (name == "hash") {
+            int mb = DEFAULT_HASH_MB;
+            try { mb = stoi(value); } catch (...) {}
+            hashMB = std::clamp(mb, 1, MAX_HASH_MB);
+            resizeHash();
+        } else if (name == "largepages") {
+            largePages = value == "true";
+            resizeHash();
+        } else if (name == "threads") {
+            // Search is single-threaded; accepted so GUIs that always send it don't complain
+        } else if (name == "evalfile") {
+            loadEvalFile(value);
+        } else if (name == "tablebasepath") {
+            loadTablebases(value);
+        } else if (name == "usennue") {
+            useNnue = value == "true";
+            updateNnue();
+        } else if (name == "nnuefile") {
+            loadNnueFile(value);
+        } else {
+            send("info string unknown option " + name);
+        }
+    }
+
+    void handlePosition(istringstream& in) {
+        string token;
+        in >> token;
+        if (token == "startpos") {
+            game.loadFEN(START_FEN);
+            in >> token;  // consume "moves" if present
+        } else if (token == "fen") {
+            string fen;
+            while (in >> token && token != "moves") {
+                fen += token + " ";
+            }
+            game.loadFEN(fen);
+        } else {
+            return;
+        }
+
+        if (token != "moves") return;
+        while (in >> token) {
+            Move move(-1, -1, -1, -1);
+            if (!parseUciMove(game, token, move)) {
+                send("info string illegal move " + token);
+                return;
+            }
+            game.makeEngineMove(move);
+        }
+    }
+
+    void handleGo(istringstream& in) {
+        SearchLimits limits;
+        string token;
+        while (in >> token) {
+            if (token == "depth") in >> limits.depth;
+            else if (token == "movetime") in >> limits.movetimeMs;
+            else if (token == "wtime") in >> limits.wtimeMs;
+            else if (token == "btime") in >> limits.btimeMs;
+            else if (token == "winc") in >> limits.wincMs;
+            else if (token == "binc") in >> limits.bincMs;
+            else if (token == "movestogo") in >> limits.movestogo;
+            else if (token == "nodes") in >> limits.nodes;
+            else if (token == "infinite") limits.infinite = true;
+        }
+
+        stopRequested = false;
+        searchRunning = true;
+        searchThread = thread([this, limits]() {
+            Move best = nnueEngine ? nnueEngine->getBestMove(game, limits) : engine.getBestMove(game, limits);
+            if (best.startRow == -1) {
+                // Fall back to any legal move rather than leaving the GUI hanging
+                vector<Move> legal = game.getLegalMoves();
+                if (!legal.empty()) best = legal[0];
+            }
+            // In infinite mode bestmove may only be sent after "stop"
+            while (limits.infinite && !stopRequested) {
+                this_thread::sleep_for(chrono::milliseconds(5));
+            }
+            send("bestmove " + (best.startRow == -1 ? string("0000") : moveToUci(game, best)));
+            searchRunning = false;
+        });
+    }
+
+    // Stop any running search and wait for its bestmove to be sent
+    void stopSearch() {
+        stopRequested = true;
+        // The engine clears its stop flag when a search starts, so keep
+        // raising it until the search thread has finished.
+        while (searchRunning) {
+            engine.stop();
+            if (nnueEngine) nnueEngine->stop();
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        if (searchThread.joinable()) searchThread.join();
+    }
+
+    // Finished searches still need their thread joined before the next command
+    void waitForSearch() {
+        if (searchThread.joinable() && !searchRunning) searchThread.join();
+    }
+
+    void sendInfo(const SearchResult& r) {
+        ostringstream ss;
+        long long nps = r.timeMs > 0 ? static_cast<long long>(r.nodes * 1000 / r.timeMs) : 0;
+        ss << "info depth " << r.depth
+           << " score " << scoreToUci(r.score, game.isWhiteToMove())
+           << " nodes " << r.nodes
+           << " nps " << nps
+           << " tbhits " << r.tbHits
+           << " time " << r.timeMs
+           << " hashfull " << (nnueEngine ? nnueEngine->hashfull() : engine.hashfull())
+           << " pv";
+        for (const Move& m : r.pv) ss << ' ' << moveToUci(game, m);
+        send(ss.str());
+    }
+
+public:
+    UciSession() {
+        engine.setInfoCallback([this](const SearchResult& r) { sendInfo(r); });
+        engine.setTablebase(&tablebase);
+    }
+
+    ~UciSession() { stopSearch(); }
+
+    void run() {
+        string line;
+        while (getline(cin, line)) {
+            istringstream in(line);
+            string cmd;
+            in >> cmd;
+            waitForSearch();
+
+            if (cmd == "uci") {
+                handleUci();
+            } else if (cmd == "isready") {
+                send("readyok");
+            } else if (cmd == "ucinewgame") {
+                stopSearch();
+                engine.newGame();
+                if (nnueEngine) nnueEngine->newGame();
+                game.loadFEN(START_FEN);
+            } else if (cmd == "setoption") {
+                stopSearch();
+                handleSetOption(in);
+            } else if (cmd == "position") {
+                stopSearch();
+                handlePosition(in);
+            } else if (cmd == "go") {
+                stopSearch();
+                handleGo(in);
+            } else if (cmd == "stop") {
+                stopSearch();
+            } else if (cmd == "quit") {
+                break;
+            } else if (cmd == "d") {
+                stopSearch();
+                game.displayBoard();
+                send(game.getCurrentFEN());
+            } else if (!cmd.empty()) {
+                send("info string unknown command " + cmd);
+            }
+        }
+        stopSearch();
+    }
+};
+
+int main() {
+    ios::sync_with_stdio(false);
+    UciSession session;
+    session.run();
+    return 0;
+}